@@ -0,0 +1,146 @@
+#include "../include/Graph.h"
+#include "../include/ContractionHierarchy.h"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <thread>
+using namespace std;
+
+// Contraction hierarchy benchmark on synthetic city grids (every 8th street is a faster arterial, as
+// in a real street plan): preprocessing time (one thread vs all), then the average time of a random
+// point-to-point query for A* vs the hierarchy. Every sampled hierarchy route is also checked
+// against Dijkstra's cost, and the run fails if any of them is longer.
+// Usage: CHBench [maxNodes]
+
+static const int ARTERIAL_SPACING = 8;
+static const double ARTERIAL_FACTOR = 0.3;
+static const double COST_TOLERANCE = 1e-6; // Relative, weights are summed in a different order
+
+static Graph buildGrid(int side, mt19937 &rng)
+{
+    uniform_real_distribution<double> weight(1.0, 2.0);
+    Graph grid(side * side);
+
+    for (int id = 0; id < side * side; id++)
+        grid.addNode(id, static_cast<float>(id % side), static_cast<float>(id / side));
+
+    for (int r = 0; r < side; r++)
+    {
+        for (int c = 0; c < side; c++)
+        {
+            int id = r * side + c;
+            double rowFactor = (r % ARTERIAL_SPACING == 0) ? ARTERIAL_FACTOR : 1.0;
+            double columnFactor = (c % ARTERIAL_SPACING == 0) ? ARTERIAL_FACTOR : 1.0;
+            if (c + 1 < side)
+                grid.addEdge(id, id + 1, weight(rng) * rowFactor);
+            if (r + 1 < side)
+                grid.addEdge(id, id + side, weight(rng) * columnFactor);
+        }
+    }
+
+    grid.freeze();
+    return grid;
+}
+
+// Sum of road weights along a path of node IDs, infinity if two consecutive nodes aren't joined
+static double pathCost(const Graph &graph, const vector<int> &path)
+{
+    double cost = 0.0;
+    for (int i = 0; i + 1 < path.size(); i++)
+    {
+        int edge = graph.findEdge(graph.indexOf(path[i]), graph.indexOf(path[i + 1]));
+        cost += (edge == -1) ? numeric_limits<double>::infinity() : graph.edgeWeight(edge);
+    }
+    return cost;
+}
+
+static double secondsSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    int maxNodes = (argc > 1) ? atoi(argv[1]) : 1000000;
+    int sizes[] = {10000, 100000, 1000000};
+    int threads = max(1u, thread::hardware_concurrency());
+    int mismatches = 0;
+
+    // The hierarchy logs its own progress; keep the table readable
+    streambuf *coutBuffer = cout.rdbuf();
+
+    cout << "=== CONTRACTION HIERARCHY BENCHMARK (" << threads << " threads) ===" << endl;
+    cout << setw(10) << "Nodes" << setw(12) << "Build 1T" << setw(12) << "Build NT" << setw(12) << "Shortcuts" << setw(12) << "A* us" << setw(12) << "CH us" << setw(12) << "CH settled" << setw(10) << "Speedup" << endl;
+
+    for (int n : sizes)
+    {
+        if (n > maxNodes)
+            break;
+
+        mt19937 rng(11);
+        int side = static_cast<int>(sqrt(static_cast<double>(n)) + 0.5);
+        Graph grid = buildGrid(side, rng);
+
+        cout.rdbuf(nullptr);
+        ContractionHierarchy serial, parallel;
+        auto start = chrono::steady_clock::now();
+        serial.build(grid, 1);
+        double serialSeconds = secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        parallel.build(grid, threads);
+        double parallelSeconds = secondsSince(start);
+        cout.rdbuf(coutBuffer);
+
+        uniform_int_distribution<int> anyNode(0, side * side - 1);
+        vector<pair<int, int>> queries;
+        for (int i = 0; i < 200; i++)
+            queries.push_back({anyNode(rng), anyNode(rng)});
+
+        SearchWorkspace ws, forward, backward;
+        long long checksum = 0, settled = 0;
+
+        start = chrono::steady_clock::now();
+        for (const auto &query : queries)
+            checksum += grid.findRoute(query.first, query.second, RouteAlgorithm::ASTAR, ws).size();
+        double astarMicros = secondsSince(start) * 1e6 / queries.size();
+
+        start = chrono::steady_clock::now();
+        for (const auto &query : queries)
+        {
+            checksum += parallel.findRoute(query.first, query.second, forward, backward).size();
+            settled += forward.getSettledCount() + backward.getSettledCount();
+        }
+        double chMicros = secondsSince(start) * 1e6 / queries.size();
+
+        cout << setw(10) << side * side << fixed << setprecision(2) << setw(11) << serialSeconds << "s" << setw(11) << parallelSeconds << "s" << setw(12) << parallel.getShortcutCount() << setprecision(1) << setw(12) << astarMicros << setw(12) << chMicros << setprecision(0) << setw(12) << static_cast<double>(settled) / queries.size() << setprecision(1) << setw(9) << astarMicros / chMicros << "x" << endl;
+        if (checksum == 0)
+            cout << "(no paths found)" << endl;
+
+        // Correctness check, outside the timed loops
+        for (const auto &query : queries)
+        {
+            vector<int> expected = grid.findRoute(query.first, query.second, RouteAlgorithm::DIJKSTRA, ws);
+            vector<int> actual = parallel.findRoute(query.first, query.second, forward, backward);
+            double expectedCost = expected.empty() ? numeric_limits<double>::infinity() : pathCost(grid, expected);
+            double actualCost = actual.empty() ? numeric_limits<double>::infinity() : pathCost(grid, actual);
+            if (expectedCost == actualCost)
+                continue;
+            if (!isinf(expectedCost) && !isinf(actualCost) && fabs(expectedCost - actualCost) <= COST_TOLERANCE * expectedCost)
+                continue;
+
+            cout << "Error: CH route " << query.first << " -> " << query.second << " costs " << setprecision(6) << actualCost << ", Dijkstra found " << expectedCost << endl;
+            mismatches++;
+        }
+    }
+
+    if (mismatches > 0)
+    {
+        cout << "FAILED: " << mismatches << " hierarchy route(s) differ from Dijkstra" << endl;
+        return 1;
+    }
+    return 0;
+}
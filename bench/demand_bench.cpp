@@ -0,0 +1,129 @@
+#include "../include/Graph.h"
+#include "../include/ReachabilityIndex.h"
+#include "../include/DemandSampler.h"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+using namespace std;
+
+// Trip sampling benchmark: the old rejection loop (draw a node, redraw while it has a signal or
+// can't reach anything, then draw a destination in its component) vs DemandSampler's alias
+// tables, as the share of signalised nodes grows.
+// Also times weight updates interleaved with draws, which only rebuild the touched bucket.
+
+static const int NUM_NODES = 1000000;
+static const int NUM_TRIPS = 2000000;
+
+static int randomInt(mt19937 &rng, int maxExclusive)
+{
+    return static_cast<int>((static_cast<uint64_t>(rng()) * static_cast<uint64_t>(maxExclusive)) >> 32);
+}
+
+static double secondsSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    // A ring of two-way roads: one component, so only the signals decide who may start a trip
+    Graph map;
+    for (int i = 0; i < NUM_NODES; i++)
+        map.addNode(i, static_cast<float>(i % 1000) * 50.0f, static_cast<float>(i / 1000) * 50.0f);
+    for (int i = 0; i < NUM_NODES; i++)
+        map.addEdge(i, (i + 1) % NUM_NODES, 1.0);
+    map.freeze();
+
+    ReachabilityIndex reachability;
+    reachability.build(map);
+
+    cout << "=== DEMAND SAMPLING BENCHMARK ===" << endl;
+    cout << "Nodes: " << NUM_NODES << ", trips per case: " << NUM_TRIPS << endl;
+    cout << setw(10) << "Signals" << setw(18) << "Rejection trips/s" << setw(16) << "Draws/trip" << setw(16) << "Alias trips/s" << endl;
+
+    double signalShares[] = {0.0, 0.5, 0.9, 0.99};
+    for (double share : signalShares)
+    {
+        mt19937 rng(7);
+        vector<char> hasSignal(NUM_NODES, 0);
+        DemandSampler demand;
+        demand.build(reachability);
+        for (int i = 0; i < NUM_NODES; i++)
+        {
+            if (randomInt(rng, 10000) < share * 10000)
+            {
+                hasSignal[i] = 1;
+                demand.setExcluded(i, true);
+            }
+        }
+
+        long long checksum = 0;
+        long long draws = 0;
+        auto start = chrono::steady_clock::now();
+        for (int t = 0; t < NUM_TRIPS; t++)
+        {
+            // As SimulationEngine used to: redraw signals and nodes that can't reach anything, then
+            // redraw the destination until it differs from the origin
+            int origin = randomInt(rng, NUM_NODES);
+            draws++;
+            while (hasSignal[origin] || reachability.getComponentSize(reachability.componentOfNode(origin)) < 2)
+            {
+                origin = randomInt(rng, NUM_NODES);
+                draws++;
+            }
+            int component = reachability.componentOfNode(origin);
+            int size = reachability.getComponentSize(component);
+            int destination = reachability.memberAt(component, randomInt(rng, size));
+            while (destination == origin)
+                destination = reachability.memberAt(component, randomInt(rng, size));
+            checksum += origin + destination;
+        }
+        double rejectionSeconds = secondsSince(start);
+
+        demand.sampleOrigin(rng); // Build the tables outside the timed loop
+        start = chrono::steady_clock::now();
+        for (int t = 0; t < NUM_TRIPS; t++)
+        {
+            int origin = demand.sampleOrigin(rng);
+            checksum += origin + demand.sampleDestination(origin, rng);
+        }
+        double aliasSeconds = secondsSince(start);
+
+        cout << setw(9) << static_cast<int>(share * 100) << "%" << fixed << setprecision(0) << setw(18) << NUM_TRIPS / rejectionSeconds
+             << setprecision(2) << setw(16) << static_cast<double>(draws) / NUM_TRIPS << setprecision(0) << setw(16) << NUM_TRIPS / aliasSeconds << endl;
+        cout.unsetf(ios::fixed);
+        if (checksum < 0)
+            cout << "(no trips drawn)" << endl;
+    }
+
+    // Skewed demand that keeps changing: one weight update per 100 trips
+    mt19937 rng(11);
+    DemandSampler demand;
+    demand.build(reachability);
+    for (int i = 0; i < NUM_NODES; i++)
+        demand.setOriginWeight(i, 1.0 + randomInt(rng, 100));
+
+    long long checksum = 0;
+    auto start = chrono::steady_clock::now();
+    for (int t = 0; t < NUM_TRIPS; t++)
+    {
+        if (t % 100 == 0)
+            demand.setOriginWeight(randomInt(rng, NUM_NODES), 1.0 + randomInt(rng, 100));
+        int origin = demand.sampleOrigin(rng);
+        checksum += origin + demand.sampleDestination(origin, rng);
+    }
+    double seconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    DemandSampler rebuilt;
+    rebuilt.build(reachability);
+    rebuilt.sampleOrigin(rng);
+    double rebuildSeconds = secondsSince(start);
+
+    cout << "\nSkewed weights, 1 update per 100 trips: " << fixed << setprecision(0) << NUM_TRIPS / seconds << " trips/s" << endl;
+    cout << "Full rebuild for comparison: " << setprecision(1) << rebuildSeconds * 1000.0 << " ms" << endl;
+    if (checksum < 0)
+        cout << "(no trips drawn)" << endl;
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "../include/Graph.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+using namespace std;
+
+// Map loading benchmark: the old iostream loader (file >> from >> to >> weight, one addEdge per road)
+// vs Graph::loadFromFile (memory-mapped, from_chars, road list sized by a line count pass) vs the
+// binary map format (mapped in place, with and without the checksum pass). Writes a synthetic road
+// file with the requested number of edges, converts it, loads it every way, and deletes both files.
+// The files were just written, so these are warm page cache timings.
+// Usage: MapLoadBench [edges] [file]
+
+static void writeSyntheticMap(const string &fileName, int nodes, long long edges)
+{
+    mt19937 rng(2024);
+    uniform_int_distribution<int> node(0, nodes - 1);
+    uniform_int_distribution<int> weight(1, 500);
+
+    // Large buffered writes; the file only needs to exist, not be fast to make
+    FILE *out = fopen(fileName.c_str(), "w");
+    fprintf(out, "%d\n", nodes);
+    for (long long i = 0; i < edges; i++)
+        fprintf(out, "%d %d %.1f\n", node(rng), node(rng), weight(rng) / 10.0);
+    fclose(out);
+}
+
+// What loadFromFile used to do
+static bool legacyLoad(Graph &graph, const string &fileName)
+{
+    ifstream file(fileName);
+    if (!file.is_open())
+        return false;
+
+    int count;
+    file >> count;
+    for (int i = 0; i < count; i++)
+        graph.addNode(i, (i % 4) * 280.0f + 150.0f, (i / 4) * 240.0f + 120.0f);
+
+    int from, to;
+    double weight;
+    while (file >> from >> to >> weight)
+    {
+        if (from >= count || to >= count || from < 0 || to < 0)
+            continue;
+        graph.addEdge(from, to, weight, true);
+    }
+
+    graph.freeze();
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    long long edges = (argc > 1) ? atoll(argv[1]) : 10000000;
+    string fileName = (argc > 2) ? argv[2] : "map_load_bench.txt";
+    int nodes = static_cast<int>(max(2LL, edges / 4));
+
+    cout << "=== MAP LOAD BENCHMARK ===" << endl;
+    cout << "Writing " << edges << " edges over " << nodes << " nodes to " << fileName << "..." << endl;
+    writeSyntheticMap(fileName, nodes, edges);
+
+    ifstream probe(fileName, ios::binary | ios::ate);
+    double megabytes = probe.tellg() / (1024.0 * 1024.0);
+    probe.close();
+
+    string binaryName = fileName + ".tsmap";
+
+    // Console output from the loaders would skew the timing
+    streambuf *coutBuffer = cout.rdbuf();
+
+    const int LOADERS = 4;
+    double seconds[LOADERS];
+    int loadedEdges[LOADERS];
+    for (int run = 0; run < LOADERS; run++)
+    {
+        Graph graph;
+        cout.rdbuf(nullptr);
+        auto start = chrono::steady_clock::now();
+        bool ok;
+        if (run == 0)
+            ok = legacyLoad(graph, fileName);
+        else if (run == 1)
+            ok = graph.loadFromFile(fileName);
+        else
+            ok = graph.loadBinary(binaryName, run == 2);
+        seconds[run] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        // The text-loaded graph is the source of the binary file
+        if (ok && run == 1)
+            ok = graph.saveBinary(binaryName);
+        cout.rdbuf(coutBuffer);
+
+        if (!ok)
+        {
+            cerr << "Load failed" << endl;
+            remove(fileName.c_str());
+            remove(binaryName.c_str());
+            return 1;
+        }
+        loadedEdges[run] = graph.getNumEdges();
+    }
+
+    ifstream binaryProbe(binaryName, ios::binary | ios::ate);
+    double binaryMegabytes = binaryProbe.tellg() / (1024.0 * 1024.0);
+    binaryProbe.close();
+
+    remove(fileName.c_str());
+    remove(binaryName.c_str());
+
+    cout << fixed << setprecision(1) << "File size: " << megabytes << " MB text, " << binaryMegabytes << " MB binary" << endl;
+    cout << setw(16) << "Loader" << setw(12) << "ms" << setw(14) << "MB/s" << setw(16) << "Edges/s" << setw(14) << "CSR edges" << endl;
+    const char *names[LOADERS] = {"iostream", "mapped", "binary+check", "binary"};
+    for (int run = 0; run < LOADERS; run++)
+    {
+        double size = (run < 2) ? megabytes : binaryMegabytes;
+        cout << setw(16) << names[run] << setprecision(3) << setw(12) << seconds[run] * 1000.0 << setprecision(1) << setw(14) << size / seconds[run] << setprecision(0) << setw(16) << edges / seconds[run] << setw(14) << loadedEdges[run] << endl;
+    }
+    cout << "Speedup over iostream: " << setprecision(2) << seconds[0] / seconds[1] << "x mapped text, " << seconds[0] / seconds[2] << "x binary with checksum, " << seconds[0] / seconds[3] << "x binary" << endl;
+
+    return 0;
+}
@@ -0,0 +1,213 @@
+#include "../include/Graph.h"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <cmath>
+using namespace std;
+
+// Routing benchmark: Dijkstra queries/s on synthetic square grids, with a fresh search workspace per
+// query (what every call used to pay: O(N) setup) vs one reused workspace (lazy, stamp-based reset).
+// "Local" queries go to a node a few blocks away, where the setup cost used to dominate.
+// A second table compares Dijkstra, A* and bidirectional Dijkstra on random queries (nodes expanded and
+// queries/s). A third routes bursts of k vehicles from one origin: k A* queries vs one one-to-many search.
+// Usage: RoutingBench [maxNodes]
+
+static const int LOCAL_RADIUS = 3;
+
+static Graph buildGrid(int side, mt19937 &rng)
+{
+    // Unit spacing and weights >= 1, so the admissible A* scale works out to about 1
+    uniform_real_distribution<double> weight(1.0, 2.0);
+    Graph grid(side * side);
+
+    for (int id = 0; id < side * side; id++)
+        grid.addNode(id, static_cast<float>(id % side), static_cast<float>(id / side));
+
+    for (int r = 0; r < side; r++)
+    {
+        for (int c = 0; c < side; c++)
+        {
+            int id = r * side + c;
+            if (c + 1 < side)
+                grid.addEdge(id, id + 1, weight(rng));
+            if (r + 1 < side)
+                grid.addEdge(id, id + side, weight(rng));
+        }
+    }
+
+    grid.freeze();
+    return grid;
+}
+
+static vector<pair<int, int>> makeQueries(int side, int count, bool local, mt19937 &rng)
+{
+    uniform_int_distribution<int> anyCoord(0, side - 1);
+    uniform_int_distribution<int> offset(-LOCAL_RADIUS, LOCAL_RADIUS);
+
+    vector<pair<int, int>> queries;
+    for (int i = 0; i < count; i++)
+    {
+        int r = anyCoord(rng), c = anyCoord(rng);
+        int r2 = local ? min(side - 1, max(0, r + offset(rng))) : anyCoord(rng);
+        int c2 = local ? min(side - 1, max(0, c + offset(rng))) : anyCoord(rng);
+        queries.push_back({r * side + c, r2 * side + c2});
+    }
+    return queries;
+}
+
+// Returns queries/s; the summed path length keeps the searches from being optimised away
+static double runQueries(const Graph &grid, const vector<pair<int, int>> &queries, bool reuse, long long &checksum)
+{
+    SearchWorkspace shared;
+    auto start = chrono::steady_clock::now();
+
+    for (const auto &query : queries)
+    {
+        if (reuse)
+        {
+            checksum += grid.dijkstraAlgorithm(query.first, query.second, shared).size();
+        }
+        else
+        {
+            SearchWorkspace fresh;
+            checksum += grid.dijkstraAlgorithm(query.first, query.second, fresh).size();
+        }
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return queries.size() / seconds;
+}
+
+// Returns queries/s and the average number of nodes each query expanded
+static double runRouted(const Graph &grid, const vector<pair<int, int>> &queries, RouteAlgorithm algorithm, double &avgSettled, long long &checksum)
+{
+    SearchWorkspace ws, backward;
+    long long settled = 0;
+    auto start = chrono::steady_clock::now();
+
+    for (const auto &query : queries)
+    {
+        if (algorithm == RouteAlgorithm::BIDIRECTIONAL)
+        {
+            checksum += grid.bidirectionalDijkstra(query.first, query.second, ws, backward).size();
+            settled += backward.getSettledCount();
+        }
+        else
+            checksum += grid.findRoute(query.first, query.second, algorithm, ws).size();
+        settled += ws.getSettledCount();
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    avgSettled = static_cast<double>(settled) / queries.size();
+    return queries.size() / seconds;
+}
+
+// Returns paths/s for bursts of 'burst' random destinations from each origin
+static double runBursts(const Graph &grid, int side, int origins, int burst, bool batched, mt19937 rng, long long &checksum)
+{
+    uniform_int_distribution<int> anyNode(0, side * side - 1);
+    SearchWorkspace ws;
+    auto start = chrono::steady_clock::now();
+
+    for (int o = 0; o < origins; o++)
+    {
+        int origin = anyNode(rng);
+        vector<int> destinations(burst);
+        for (int &destination : destinations)
+            destination = anyNode(rng);
+
+        if (batched)
+        {
+            for (const vector<int> &path : grid.findRoutes(origin, destinations, ws))
+                checksum += path.size();
+        }
+        else
+        {
+            for (int destination : destinations)
+                checksum += grid.findRoute(origin, destination, RouteAlgorithm::ASTAR, ws).size();
+        }
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return static_cast<double>(origins) * burst / seconds;
+}
+
+int main(int argc, char *argv[])
+{
+    int maxNodes = (argc > 1) ? atoi(argv[1]) : 1000000;
+    int sizes[] = {1000, 10000, 100000, 1000000};
+
+    cout << "=== ROUTING BENCHMARK ===" << endl;
+    cout << setw(10) << "Nodes" << setw(8) << "Query" << setw(18) << "Fresh queries/s" << setw(19) << "Reused queries/s" << setw(10) << "Speedup" << endl;
+
+    for (int n : sizes)
+    {
+        if (n > maxNodes)
+            break;
+
+        mt19937 rng(99);
+        int side = static_cast<int>(sqrt(static_cast<double>(n)) + 0.5);
+        Graph grid = buildGrid(side, rng);
+
+        for (bool local : {false, true})
+        {
+            // Scale the query count so every case takes roughly the same time
+            int count = local ? max(200, 20000000 / n) : max(20, 2000000 / n);
+            vector<pair<int, int>> queries = makeQueries(side, count, local, rng);
+
+            long long checksum = 0;
+            double fresh = runQueries(grid, queries, false, checksum);
+            double reused = runQueries(grid, queries, true, checksum);
+
+            cout << setw(10) << side * side << setw(8) << (local ? "local" : "random") << fixed << setprecision(0) << setw(18) << fresh << setw(19) << reused << setprecision(2) << setw(9) << reused / fresh << "x" << endl;
+            if (checksum == 0)
+                cout << "(no paths found)" << endl;
+        }
+    }
+
+    cout << endl << setw(10) << "Nodes" << setw(16) << "Dijkstra nodes" << setw(12) << "A* nodes" << setw(14) << "Bidir nodes" << setw(16) << "Dijkstra q/s" << setw(12) << "A* q/s" << setw(12) << "Bidir q/s" << endl;
+
+    for (int n : sizes)
+    {
+        if (n > maxNodes)
+            break;
+
+        mt19937 rng(7);
+        int side = static_cast<int>(sqrt(static_cast<double>(n)) + 0.5);
+        Graph grid = buildGrid(side, rng);
+        vector<pair<int, int>> queries = makeQueries(side, max(20, 2000000 / n), false, rng);
+
+        long long checksum = 0;
+        double dijkstraSettled, astarSettled, bidirSettled;
+        double dijkstra = runRouted(grid, queries, RouteAlgorithm::DIJKSTRA, dijkstraSettled, checksum);
+        double astar = runRouted(grid, queries, RouteAlgorithm::ASTAR, astarSettled, checksum);
+        double bidir = runRouted(grid, queries, RouteAlgorithm::BIDIRECTIONAL, bidirSettled, checksum);
+
+        cout << setw(10) << side * side << fixed << setprecision(0) << setw(16) << dijkstraSettled << setw(12) << astarSettled << setw(14) << bidirSettled << setprecision(1) << setw(16) << dijkstra << setw(12) << astar << setw(12) << bidir << endl;
+    }
+
+    cout << endl << setw(10) << "Nodes" << setw(8) << "Burst" << setw(18) << "A* paths/s" << setw(18) << "Batch paths/s" << setw(10) << "Speedup" << endl;
+
+    for (int n : sizes)
+    {
+        if (n > maxNodes)
+            break;
+
+        mt19937 rng(11);
+        int side = static_cast<int>(sqrt(static_cast<double>(n)) + 0.5);
+        Graph grid = buildGrid(side, rng);
+
+        for (int burst : {8, 64})
+        {
+            int origins = max(2, 4000000 / (n * burst));
+            long long checksum = 0;
+            double single = runBursts(grid, side, origins, burst, false, rng, checksum);
+            double batched = runBursts(grid, side, origins, burst, true, rng, checksum);
+
+            cout << setw(10) << side * side << setw(8) << burst << fixed << setprecision(1) << setw(18) << single << setw(18) << batched << setprecision(2) << setw(9) << batched / single << "x" << endl;
+        }
+    }
+
+    return 0;
+}
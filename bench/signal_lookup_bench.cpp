@@ -0,0 +1,77 @@
+#include "../include/TrafficSignal.h"
+#include "../include/SignalIndex.h"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+using namespace std;
+
+// Signal resolution benchmark: linear scan over all signals (the old update()/hasSignal() loop)
+// vs the dense SignalIndex table, as the number of signalised intersections grows.
+
+static const int NUM_NODES = 100000;
+static const int NUM_LOOKUPS = 200000; // vehicles reaching a node
+
+static int findByScan(const vector<TrafficSignal> &signals, int nodeID)
+{
+    for (int i = 0; i < signals.size(); i++)
+    {
+        if (signals[i].getIntersectionID() == nodeID)
+            return i;
+    }
+    return -1;
+}
+
+int main()
+{
+    int signalCounts[] = {10, 100, 1000, 10000};
+    mt19937 rng(2024);
+    uniform_int_distribution<int> anyNode(0, NUM_NODES - 1);
+
+    // Node IDs 0..N-1, so IDs and dense indices coincide and the scan and the index see the same keys
+    streambuf *coutBuffer = cout.rdbuf(nullptr);
+    Graph map(NUM_NODES);
+    cout.rdbuf(coutBuffer);
+
+    vector<int> lookups(NUM_LOOKUPS);
+    for (int &node : lookups)
+        node = anyNode(rng);
+
+    cout << "=== SIGNAL LOOKUP BENCHMARK ===" << endl;
+    cout << "Nodes: " << NUM_NODES << ", lookups per case: " << NUM_LOOKUPS << endl;
+    cout << setw(10) << "Signals" << setw(18) << "Scan lookups/s" << setw(18) << "Index lookups/s" << setw(16) << "Rebuild (ms)" << endl;
+
+    for (int count : signalCounts)
+    {
+        // Signal constructors log every creation; keep that out of the output
+        streambuf *coutBuffer = cout.rdbuf(nullptr);
+        vector<TrafficSignal> signals;
+        for (int i = 0; i < count; i++)
+            signals.push_back(TrafficSignal(i + 1, (i * 7919) % NUM_NODES, sf::Vector2<float>(0.0f, 0.0f)));
+        cout.rdbuf(coutBuffer);
+
+        long long found = 0;
+
+        auto start = chrono::steady_clock::now();
+        for (int node : lookups)
+            found += (findByScan(signals, node) != -1);
+        double scanSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        SignalIndex index;
+        start = chrono::steady_clock::now();
+        index.rebuild(signals, map);
+        double rebuildSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        start = chrono::steady_clock::now();
+        for (int node : lookups)
+            found -= (index.find(node) != -1);
+        double indexSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        if (found != 0)
+            cout << "Mismatch between scan and index results!" << endl;
+
+        cout << setw(10) << count << fixed << setprecision(0) << setw(18) << NUM_LOOKUPS / scanSeconds << setw(18) << NUM_LOOKUPS / indexSeconds << setprecision(3) << setw(16) << rebuildSeconds * 1000.0 << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "../include/Graph.h"
+#include "../include/SpatialGrid.h"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+using namespace std;
+
+// Spatial query benchmark: linear scans over every node (what picking or culling would otherwise
+// do) vs the SpatialGrid, for nearest-node queries and screen-sized range queries, as maps grow.
+// Nodes are scattered over a square city with about 50 units between neighbours.
+
+static const int NUM_QUERIES = 2000;
+
+static int nearestByScan(const Graph &map, sf::Vector2<float> point)
+{
+    int best = -1;
+    double bestSquared = numeric_limits<double>::infinity();
+    for (int i = 0; i < map.getNumNodes(); i++)
+    {
+        double dx = map.nodeAt(i).position.x - point.x;
+        double dy = map.nodeAt(i).position.y - point.y;
+        if (dx * dx + dy * dy < bestSquared)
+        {
+            bestSquared = dx * dx + dy * dy;
+            best = i;
+        }
+    }
+    return best;
+}
+
+static int rangeByScan(const Graph &map, float left, float top, float right, float bottom)
+{
+    int count = 0;
+    for (int i = 0; i < map.getNumNodes(); i++)
+    {
+        sf::Vector2<float> p = map.nodeAt(i).position;
+        count += (p.x >= left && p.x <= right && p.y >= top && p.y <= bottom);
+    }
+    return count;
+}
+
+int main()
+{
+    int nodeCounts[] = {1000, 10000, 100000, 500000};
+    mt19937 rng(2024);
+
+    cout << "=== SPATIAL QUERY BENCHMARK ===" << endl;
+    cout << "Queries per case: " << NUM_QUERIES << " nearest + " << NUM_QUERIES << " range (1200x800 window)" << endl;
+    cout << setw(10) << "Nodes" << setw(12) << "Build ms" << setw(16) << "Scan near/s" << setw(16) << "Grid near/s" << setw(16) << "Scan range/s" << setw(16) << "Grid range/s" << endl;
+
+    for (int count : nodeCounts)
+    {
+        float side = 50.0f * sqrt(static_cast<float>(count));
+        uniform_real_distribution<float> coordinate(0.0f, side);
+
+        Graph map;
+        for (int i = 0; i < count; i++)
+            map.addNode(i, coordinate(rng), coordinate(rng));
+        map.freeze();
+
+        vector<sf::Vector2<float>> points(NUM_QUERIES);
+        for (sf::Vector2<float> &p : points)
+            p = sf::Vector2<float>(coordinate(rng), coordinate(rng));
+
+        auto start = chrono::steady_clock::now();
+        SpatialGrid grid;
+        grid.build(map);
+        double buildSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        long long checksum[2] = {0, 0};
+        double seconds[4];
+
+        start = chrono::steady_clock::now();
+        for (sf::Vector2<float> p : points)
+            checksum[0] += nearestByScan(map, p);
+        seconds[0] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        start = chrono::steady_clock::now();
+        for (sf::Vector2<float> p : points)
+            checksum[1] += grid.nearest(p);
+        seconds[1] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        long long found[2] = {0, 0};
+        start = chrono::steady_clock::now();
+        for (sf::Vector2<float> p : points)
+            found[0] += rangeByScan(map, p.x, p.y, p.x + 1200.0f, p.y + 800.0f);
+        seconds[2] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        vector<int> inView;
+        start = chrono::steady_clock::now();
+        for (sf::Vector2<float> p : points)
+        {
+            inView.clear();
+            grid.queryRange(p.x, p.y, p.x + 1200.0f, p.y + 800.0f, inView);
+            found[1] += inView.size();
+        }
+        seconds[3] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << setw(10) << count << fixed << setprecision(2) << setw(12) << buildSeconds * 1000.0 << setprecision(0);
+        for (double s : seconds)
+            cout << setw(16) << NUM_QUERIES / s;
+        cout << endl;
+
+        if (checksum[0] != checksum[1] || found[0] != found[1])
+            cout << "Warning: grid and scan results differ" << endl;
+    }
+
+    return 0;
+}
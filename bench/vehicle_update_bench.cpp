@@ -0,0 +1,108 @@
+#include "../include/Vehicle.h"
+#include "../include/VehicleStore.h"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+using namespace std;
+
+// Vehicle movement benchmark: array-of-structs (vector<Vehicle>) vs the column store (VehicleStore).
+// Half of the fleet has arrived, as in a long run where finished trips are still stored.
+// Usage: VehicleUpdateBench [arrivedFraction]
+
+static const float DELTA_TIME = 1.0f / 60.0f;
+static const long long UPDATES_PER_CASE = 50000000; // vehicle-ticks per measurement
+
+static Vehicle makeVehicle(int id, mt19937 &rng, bool arrived)
+{
+    uniform_real_distribution<float> coord(0.0f, 1000.0f);
+    uniform_real_distribution<float> speed(0.8f, 1.5f);
+
+    Vehicle car(id, {0, 1, 2, 3}, speed(rng), 0);
+    sf::Vector2<float> start(coord(rng), coord(rng));
+    car.setPosition(start);
+    car.setStartPosition(start);
+    car.setTargetPosition(sf::Vector2<float>(coord(rng), coord(rng)));
+    if (arrived)
+        car.setStatus(VehicleStatus::ARRIVED);
+    return car;
+}
+
+static double benchArrayOfStructs(vector<Vehicle> &cars, int ticks)
+{
+    auto start = chrono::steady_clock::now();
+
+    for (int t = 0; t < ticks; t++)
+    {
+        // Same shape as the old Simulation::update() vehicle loop
+        for (auto &car : cars)
+        {
+            if (car.hasArrivedDest())
+                continue;
+
+            if (car.canMove())
+            {
+                car.updateVisualPosition(DELTA_TIME);
+                if (car.getInterpolation() >= 1.0f)
+                    car.setTargetPosition(car.getStartPosition());
+            }
+        }
+    }
+
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static double benchStructOfArrays(VehicleStore &store, int ticks)
+{
+    vector<int> reached;
+    auto start = chrono::steady_clock::now();
+
+    for (int t = 0; t < ticks; t++)
+    {
+        reached.clear();
+        store.updatePositions(DELTA_TIME, reached);
+        for (int row : reached)
+            store.setTargetPosition(row, store.getPosition(row));
+    }
+
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    double arrivedFraction = (argc > 1) ? atof(argv[1]) : 0.5;
+    int sizes[] = {10000, 100000, 1000000};
+
+    cout << "=== VEHICLE UPDATE BENCHMARK ===" << endl;
+    cout << "Arrived fraction: " << arrivedFraction << endl;
+    cout << setw(10) << "Vehicles" << setw(20) << "AoS updates/s" << setw(20) << "SoA updates/s" << setw(10) << "Speedup" << endl;
+
+    for (int n : sizes)
+    {
+        mt19937 rng(12345);
+        bernoulli_distribution isArrived(arrivedFraction);
+
+        vector<Vehicle> cars;
+        VehicleStore store;
+        cars.reserve(n);
+        store.reserve(n);
+
+        for (int i = 0; i < n; i++)
+        {
+            Vehicle car = makeVehicle(i + 1, rng, isArrived(rng));
+            cars.push_back(car);
+            store.add(car);
+        }
+
+        int ticks = max(1LL, UPDATES_PER_CASE / n);
+
+        // Updates are counted over the whole fleet, since that's what each tick has to get through
+        double aosSeconds = benchArrayOfStructs(cars, ticks);
+        double soaSeconds = benchStructOfArrays(store, ticks);
+        double updates = static_cast<double>(n) * ticks;
+
+        cout << setw(10) << n << fixed << setprecision(0) << setw(20) << updates / aosSeconds << setw(20) << updates / soaSeconds << setprecision(2) << setw(9) << aosSeconds / soaSeconds << "x" << endl;
+    }
+
+    return 0;
+}
@@ -1 +1,35 @@
-g++ -std=c++17 src/*.cpp -I./include -IC:\\SFML-3.0.2\\include -LC:\\SFML-3.0.2\\lib -lsfml-graphics -lsfml-window -lsfml-system -o TrafficSimulator.exe
\ No newline at end of file
+$SFML = "C:\SFML-3.0.2"
+
+# Core engine library (no SFML graphics/window dependency, only SFML/System headers; uses std::thread, so link with -pthread)
+$core = @("src/Graph.cpp", "src/Vehicle.cpp", "src/VehicleStore.cpp", "src/RoutePool.cpp", "src/TrafficSignal.cpp", "src/SignalIndex.cpp", "src/SpatialGrid.cpp", "src/ReachabilityIndex.cpp", "src/AliasTable.cpp", "src/DemandSampler.cpp", "src/DemandSchedule.cpp", "src/CongestionModel.cpp", "src/SearchWorkspace.cpp", "src/ContractionHierarchy.cpp", "src/NextHopTable.cpp", "src/MappedFile.cpp", "src/TextScanner.cpp", "src/RouteCache.cpp", "src/ActionStack.cpp", "src/EmergencyManager.cpp", "src/Analytics.cpp", "src/SimulationEngine.cpp")
+
+New-Item -ItemType Directory -Force -Path build | Out-Null
+$objects = @()
+foreach ($src in $core) {
+    $obj = "build/" + [System.IO.Path]::GetFileNameWithoutExtension($src) + ".o"
+    g++ -std=c++17 -O2 -c $src -I./include "-I$SFML\include" -o $obj
+    if ($LASTEXITCODE -ne 0) { exit 1 }
+    $objects += $obj
+}
+ar rcs build/libtrafficcore.a $objects
+
+# Windowed simulator
+g++ -std=c++17 -O2 src/main.cpp src/Simulation.cpp -I./include "-I$SFML\include" -Lbuild -ltrafficcore "-L$SFML\lib" -lsfml-graphics -lsfml-window -lsfml-system -pthread -o TrafficSimulator.exe
+
+# Headless runner (batch servers, faster than real time)
+g++ -std=c++17 -O2 src/headless.cpp -I./include "-I$SFML\include" -Lbuild -ltrafficcore -pthread -o TrafficHeadless.exe
+
+# Benchmarks
+g++ -std=c++17 -O2 bench/vehicle_update_bench.cpp -I./include "-I$SFML\include" -Lbuild -ltrafficcore -pthread -o VehicleUpdateBench.exe
+g++ -std=c++17 -O2 bench/signal_lookup_bench.cpp -I./include "-I$SFML\include" -Lbuild -ltrafficcore -pthread -o SignalLookupBench.exe
+g++ -std=c++17 -O2 bench/routing_bench.cpp -I./include "-I$SFML\include" -Lbuild -ltrafficcore -pthread -o RoutingBench.exe
+g++ -std=c++17 -O2 bench/ch_bench.cpp -I./include "-I$SFML\include" -Lbuild -ltrafficcore -pthread -o CHBench.exe
+g++ -std=c++17 -O2 bench/map_load_bench.cpp -I./include "-I$SFML\include" -Lbuild -ltrafficcore -pthread -o MapLoadBench.exe
+g++ -std=c++17 -O2 bench/spatial_bench.cpp -I./include "-I$SFML\include" -Lbuild -ltrafficcore -pthread -o SpatialBench.exe
+g++ -std=c++17 -O2 bench/demand_bench.cpp -I./include "-I$SFML\include" -Lbuild -ltrafficcore -pthread -o DemandBench.exe
+
+# Tools
+g++ -std=c++17 -O2 tools/build_ch.cpp -I./include "-I$SFML\include" -Lbuild -ltrafficcore -pthread -o BuildCH.exe
+g++ -std=c++17 -O2 tools/build_nexthop.cpp -I./include "-I$SFML\include" -Lbuild -ltrafficcore -pthread -o BuildNextHop.exe
+g++ -std=c++17 -O2 tools/convert_map.cpp -I./include "-I$SFML\include" -Lbuild -ltrafficcore -pthread -o ConvertMap.exe
+g++ -std=c++17 -O2 tools/osm_import.cpp -I./include "-I$SFML\include" -Lbuild -ltrafficcore -pthread -o OsmImport.exe
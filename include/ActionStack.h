@@ -4,6 +4,7 @@
 #include "Stack.h"
 #include <string>
 #include "TrafficSignal.h"
+#include "VehicleHandle.h"
 using namespace std;
 
 enum class ActionType
@@ -19,13 +20,13 @@ struct Action
     SignalState previousState; // For signal toggles
     SignalState newState;      // For signal toggles
     float timestamp;           // When action occurred
-    int vehicleIndex;          // For vehicle spawns (position in vector)
+    VehicleHandle vehicle;     // For vehicle spawns (handle into the vehicle store)
 
     // Constructor for signal actions
-    Action(ActionType type, int id, SignalState prev, SignalState next, float time) : type(type), targetID(id), previousState(prev), newState(next), timestamp(time), vehicleIndex(vehicleIndex) {}
+    Action(ActionType type, int id, SignalState prev, SignalState next, float time) : type(type), targetID(id), previousState(prev), newState(next), timestamp(time), vehicle() {}
 
     // Constructor for non-signal actions
-    Action(ActionType type, int vehicleID, int vehicleIndex, float time) : type(type), targetID(vehicleID), previousState(SignalState::GREEN), newState(SignalState::GREEN), timestamp(time), vehicleIndex(vehicleIndex) {}
+    Action(ActionType type, int vehicleID, VehicleHandle handle, float time) : type(type), targetID(vehicleID), previousState(SignalState::GREEN), newState(SignalState::GREEN), timestamp(time), vehicle(handle) {}
 };
 
 class ActionStack
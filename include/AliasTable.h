@@ -0,0 +1,81 @@
+#ifndef ALIASTABLE_H
+#define ALIASTABLE_H
+
+#include <vector>
+#include <random>
+#include <cstdint>
+using namespace std;
+
+// Walker/Vose alias table: O(n) to build, then O(1) per weighted draw from a single 32-bit
+// output of the generator. Its top bits pick a column (multiply-shift) and the rest flip the
+// column's biased coin, all in integers, so a seed gives the same picks on every platform.
+// Items with zero weight are never drawn.
+class AliasTable
+{
+public:
+    struct Entry
+    {
+        uint32_t threshold; // Keep the column if the coin is below this
+        int alias;          // Otherwise take this item (the column itself when it is full)
+    };
+
+    // Build 'count' entries for 'weights' into 'out'; returns the total weight (0 if nothing positive)
+    static double fill(const double *weights, int count, Entry *out);
+    // Weighted pick among 'count' filled entries
+    static int pick(const Entry *entries, int count, uint32_t draw)
+    {
+        uint64_t scaled = static_cast<uint64_t>(draw) * static_cast<uint64_t>(count);
+        int column = static_cast<int>(scaled >> 32);
+        uint32_t coin = static_cast<uint32_t>(scaled); // The fraction left over is uniform too
+        return (coin < entries[column].threshold) ? column : entries[column].alias;
+    }
+
+private:
+    vector<Entry> entries;
+    double total;
+
+public:
+    AliasTable();
+
+    void build(const double *weights, int count);
+    void clear();
+
+    bool empty() const { return !(total > 0.0); } // Nothing can be drawn
+    int size() const { return static_cast<int>(entries.size()); }
+    double getTotal() const { return total; }
+
+    int sample(mt19937 &rng) const { return empty() ? -1 : pick(entries.data(), size(), rng()); }
+};
+
+// Alias tables over fixed-size buckets of items, plus one over the bucket totals. Changing a weight
+// only marks its bucket; the next draw rebuilds that bucket and the small top table, so an update
+// costs O(BUCKET_SIZE + buckets) instead of a full rebuild. Draws stay O(1). All buckets share one
+// entry array, so a draw touches one entry there.
+class BucketedAliasTable
+{
+    vector<double> weights;
+    vector<AliasTable::Entry> entries; // Bucket b owns entries [b * BUCKET_SIZE, ...)
+    vector<double> bucketTotals;
+    AliasTable top;
+    vector<int> dirtyBuckets;
+    vector<char> isDirty;
+    bool topDirty;
+
+    void refresh();
+    int bucketSize(int bucket) const;
+
+public:
+    static const int BUCKET_SIZE = 1024;
+
+    BucketedAliasTable();
+
+    void assign(const vector<double> &itemWeights);
+    void set(int item, double weight); // Takes effect at the next draw
+    double get(int item) const { return weights[item]; }
+    int size() const { return static_cast<int>(weights.size()); }
+
+    double getTotal();
+    int sample(mt19937 &rng); // -1 if every weight is zero
+};
+
+#endif
@@ -3,8 +3,7 @@
 
 #include <vector>
 #include <string>
-#include <unordered_map>
-#include "Vehicle.h"
+#include "VehicleStore.h"
 #include "TrafficSignal.h"
 #include "Graph.h"
 using namespace std;
@@ -20,6 +19,23 @@ struct RoadCongestion
     RoadCongestion(int from, int to, int count = 0, double speed = 0.0) : fromNode(from), toNode(to), vehicleCount(count), averageSpeed(speed) {}
 };
 
+// Compact record of a finished trip, kept after the vehicle itself is retired from the store
+struct TripRecord
+{
+    int vehicleID;
+    int originNode;
+    int destNode;
+    int priority;
+    float spawnTime;
+    float arrivalTime;
+    float expectedArrival; // Predicted at spawn, -1 if none was made
+
+    TripRecord(int id, int origin, int dest, int p, float spawn, float arrival, float expected = -1.0f) : vehicleID(id), originNode(origin), destNode(dest), priority(p), spawnTime(spawn), arrivalTime(arrival), expectedArrival(expected) {}
+
+    float travelTime() const { return arrivalTime - spawnTime; }
+    bool hasPrediction() const { return expectedArrival >= 0.0f; }
+};
+
 struct SimulationStats
 {
     int totalVehiclesSpawned;
@@ -39,35 +55,44 @@ struct SimulationStats
     int totalQueuedVehicles;
     double averageQueueSize;
 
-    SimulationStats() : totalVehiclesSpawned(0), currentActiveVehicles(0), totalArrivedVehicles(0), totalEmergencyVehicles(0), averageTravelTime(0.0), simulationDuration(0.0), totalSignalToggles(0), totalUndoOperations(0), busiestRoadCount(0), totalQueuedVehicles(0), averageQueueSize(0.0) {}
+    int predictedTrips;     // Finished trips that had an ETA
+    double averageETAError; // Mean |arrival - ETA| over them, seconds
+    double averageETABias;  // Mean arrival - ETA (positive: later than predicted)
+
+    SimulationStats() : totalVehiclesSpawned(0), currentActiveVehicles(0), totalArrivedVehicles(0), totalEmergencyVehicles(0), averageTravelTime(0.0), simulationDuration(0.0), totalSignalToggles(0), totalUndoOperations(0), busiestRoadCount(0), totalQueuedVehicles(0), averageQueueSize(0.0), predictedTrips(0), averageETAError(0.0), averageETABias(0.0) {}
 };
 
 class Analytics
 {
-    // Road usage tracking
-    unordered_map<string, int> roadUsage; // "from-to" -> count
+    // Road usage tracking: one counter per directed CSR edge of the road network
+    const Graph *roadNetwork;
+    vector<int> edgeUsage;
+    int roadSegmentsUsed;
 
     // Statistics
     SimulationStats stats;
 
-    // Vehicle spawn/arrival times
-    unordered_map<int, float> vehicleSpawnTimes;
-    unordered_map<int, float> vehicleArrivalTimes;
+    // Finished trips (appended as vehicles retire) and running totals over them
+    vector<TripRecord> trips;
+    double totalTravelTime;
+    double totalETAError; // Over trips with a prediction
+    double totalETABias;
+    int predictedTrips;
 
     // Merge sort implementation
     void mergeSort(vector<RoadCongestion> &roads, int left, int right);
     void merge(vector<RoadCongestion> &roads, int left, int mid, int right);
 
-    // Create road key
-    string getRoadKey(int from, int to) const;
-
 public:
     Analytics();
 
+    // Size the per-edge counters for a (frozen) road network; must be called again after the map changes
+    void setRoadNetwork(const Graph *graph);
+
     // Track events
-    void recordVehicleSpawn(int vehicleID, float time, bool isEmergency);
-    void recordVehicleArrival(int vehicleID, float time);
-    void recordRoadUsage(int fromNode, int toNode);
+    void recordVehicleSpawn(bool isEmergency);
+    void recordTrip(const TripRecord &trip); // Called once per vehicle when it retires at its destination
+    void recordRoadUsage(int edge); // CSR edge ID from Graph::findEdge()
     void recordSignalToggle();
     void recordUndoOperation();
 
@@ -77,9 +102,11 @@ public:
     RoadCongestion getBusiestRoad();
 
     // Statistics
-    void updateStats(const vector<Vehicle> &vehicles, const vector<TrafficSignal> &signals, float currentTime);
+    void updateStats(const VehicleStore &vehicles, const vector<TrafficSignal> &signals, float currentTime);
 
     SimulationStats getStats() const;
+    const vector<TripRecord> &getTrips() const;
+    int getCompletedTrips() const;
     double getAverageTravelTime() const;
 
     // File operations
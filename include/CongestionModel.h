@@ -0,0 +1,49 @@
+#ifndef CONGESTIONMODEL_H
+#define CONGESTIONMODEL_H
+
+#include <vector>
+#include <utility>
+#include "Graph.h"
+using namespace std;
+
+// Live travel-time estimates per road, from what the engine observes: how many vehicles are on a
+// road (moving or queued at the signal at its end), sampled every so often, and how many turned
+// onto it. Little's law turns the two into an average time per traversal for each window; an
+// exponentially weighted moving average smooths it, and the road's weight becomes its free-flow
+// weight scaled by smoothed time / free-flow time. Only weights that moved by more than a
+// threshold are written back, so quiet roads don't churn the route cache. Only roads that saw
+// traffic, or are still above free flow, are visited per window.
+class CongestionModel
+{
+    vector<double> baseWeights;   // Free-flow weight of each edge (the map's weights at reset)
+    vector<double> smoothedTimes; // Seconds per traversal, smoothed
+    vector<int> occupancy;        // Vehicles seen on the edge, summed over this window's samples
+    vector<int> entries;          // Vehicles that turned onto the edge this window
+    vector<char> active;
+    vector<int> activeEdges;
+    int samples;                  // Occupancy samples taken this window
+    double freeFlowTime;          // Seconds to drive an empty road
+
+    void activate(int edge);
+
+public:
+    CongestionModel();
+
+    void reset(const Graph &map, double freeFlowSeconds);
+    void clear();
+    bool empty() const { return baseWeights.empty(); }
+
+    void addOccupancy(int edge) { activate(edge); occupancy[edge]++; } // One vehicle on the road in this sample
+    void finishSample() { samples++; }
+    void addEntry(int edge) { activate(edge); entries[edge]++; }      // A vehicle turned onto the road
+
+    // Close a window of 'windowSeconds': update the estimates and write significant weight
+    // changes into 'map'. Roads that got slower go to 'slower' as (edge ID, weight increase).
+    void update(Graph &map, double windowSeconds, vector<pair<int, double>> &slower);
+
+    double getFactor(int edge) const { return smoothedTimes[edge] / freeFlowTime; } // 1 at free flow
+    double getBaseWeight(int edge) const { return baseWeights[edge]; }
+    int getCongestedCount() const; // Roads at least 50% slower than free flow
+};
+
+#endif
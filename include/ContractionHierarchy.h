@@ -0,0 +1,70 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "Graph.h"
+#include "SearchWorkspace.h"
+using namespace std;
+
+// One arc of the hierarchy. A shortcut stands for the two arcs through 'via', the node that was
+// contracted to create it; original roads have via == -1.
+struct CHArc
+{
+    double weight;
+    int node;
+    int via;
+};
+
+// Contraction Hierarchy over a frozen Graph, for fast point-to-point routes on large maps.
+// build() contracts nodes one independent set at a time (the shortcut searches for a set run in
+// parallel), adding shortcuts so that distances between the remaining nodes are preserved.
+// Queries then only ever search "upward" in contraction order from both ends, which settles a
+// tiny fraction of the nodes Dijkstra or A* would. The result can be saved and reloaded.
+// Routes are the same cost as Dijkstra's; weights are fixed at build time.
+class ContractionHierarchy
+{
+    const Graph *graph; // Map the hierarchy was built or loaded for (external ID lookups)
+    int numNodes;
+    int numEdges;         // Edge count of the source graph, checked when loading
+    uint64_t fingerprint; // Graph::computeFingerprint() of the source graph, checked when loading
+    vector<int> nodeIDs;  // dense index -> external ID
+    vector<int> rank;     // dense index -> contraction order (higher = more important)
+    int shortcutCount;
+
+    // Upward arcs in CSR form: up[u] holds u -> v with rank[v] > rank[u] (forward search),
+    // down[u] holds x -> u with rank[x] > rank[u], stored at u with node = x (backward search)
+    vector<int> upOffsets;
+    vector<CHArc> upArcs;
+    vector<int> downOffsets;
+    vector<CHArc> downArcs;
+
+    // Scratch space for the non-const findRoute()
+    SearchWorkspace forwardSearch;
+    SearchWorkspace backwardSearch;
+
+    const CHArc *findArc(int from, int to) const;
+    void unpackArc(int from, int to, vector<int> &path) const; // Appends the nodes after 'from' up to 'to'
+
+public:
+    ContractionHierarchy();
+
+    // Preprocess 'map' (must be frozen); threads <= 0 uses every hardware thread
+    bool build(const Graph &map, int threads = 0);
+    bool isReady() const;
+
+    // Shortest path between external node IDs, as the node list Vehicle consumes
+    vector<int> findRoute(int start, int end);
+    // Same query with caller-owned scratch space (one pair per thread)
+    vector<int> findRoute(int start, int end, SearchWorkspace &forward, SearchWorkspace &backward) const;
+
+    // File I/O (binary; only valid for the same map it was built from)
+    bool saveToFile(const string &fileName) const;
+    bool loadFromFile(const string &fileName, const Graph &map);
+
+    int getNumNodes() const;
+    int getShortcutCount() const;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef DEMANDSAMPLER_H
+#define DEMANDSAMPLER_H
+
+#include <vector>
+#include <random>
+#include "AliasTable.h"
+#include "ReachabilityIndex.h"
+using namespace std;
+
+// Draws trip ends from per-node origin and destination weights (all 1 by default) with alias
+// tables, so each draw is O(1) however many nodes are excluded. Destinations are drawn from the
+// origin's strongly connected component, so every pair is routable. A node is never drawn as an
+// origin while it is excluded (e.g. has a signal) or when nothing else in its component can be a
+// destination. Weight changes rebuild only the bucket they fall in, at the next draw.
+// Works on dense node indices.
+class DemandSampler
+{
+    const ReachabilityIndex *components;
+    vector<int> positionOf; // dense index -> k, where the node is memberAt(its component, k)
+
+    vector<double> originWeights;
+    vector<double> destinationWeights;
+    vector<char> excluded;
+    vector<int> positiveDestinations; // Per component: members with destination weight > 0
+
+    BucketedAliasTable origins;             // Over dense indices, effective weights
+    vector<BucketedAliasTable> destinations; // Per component, over its members
+
+    double effectiveOriginWeight(int index) const;
+    void refreshOrigins(int component); // Re-evaluate every member after the component's destinations changed
+
+public:
+    DemandSampler();
+
+    void build(const ReachabilityIndex &reachability); // Uniform weights, nothing excluded
+    void clear();
+
+    void setOriginWeight(int index, double weight); // Negative weights count as 0
+    void setDestinationWeight(int index, double weight);
+    void setExcluded(int index, bool isExcluded);   // Keeps the weight, but never draws the node as an origin
+    double getOriginWeight(int index) const { return originWeights[index]; }
+    double getDestinationWeight(int index) const { return destinationWeights[index]; }
+    bool isExcluded(int index) const { return excluded[index] != 0; }
+
+    int sampleOrigin(mt19937 &rng);                       // -1 if no node can start a trip
+    int sampleDestination(int originIndex, mt19937 &rng); // Same component, not the origin; -1 if none
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef DEMANDSCHEDULE_H
+#define DEMANDSCHEDULE_H
+
+#include <vector>
+#include <string>
+#include <random>
+#include "Graph.h"
+#include "ReachabilityIndex.h"
+#include "PriorityQueue.h"
+using namespace std;
+
+// Time-of-day rate multiplier: a step function over one period, repeating.
+// factors[i] holds from starts[i] until starts[i + 1] (the last one wraps around to the first).
+struct RateProfile
+{
+    string name;
+    vector<double> starts; // Seconds into the period, ascending, starts[0] == 0
+    vector<double> factors;
+    double integral;       // Factor-seconds over one whole period
+};
+
+// One OD matrix entry: a Poisson stream of trips from one node to another
+struct DemandFlow
+{
+    int from;            // Node ID
+    int to;              // Node ID, or -1 for a destination drawn from the spawn weights
+    double ratePerSecond; // At profile factor 1
+    int profile;         // Index into the profiles, -1 for a constant rate
+};
+
+// OD demand read from a file and turned into Poisson arrivals. Every flow keeps its next arrival
+// time in one indexed heap, so popping the trips due by a tick costs O(log flows) per trip however
+// large the matrix is. Arrival gaps are drawn by inverting the flow's integrated rate, which is
+// exact for piecewise-constant profiles (no thinning, no rejected draws).
+//
+// File format (whitespace separated, '#' starts a comment; times are seconds or hh:mm[:ss]):
+//   start 07:00                          clock time at simulation time 0 (default 0)
+//   period 24:00                         profiles repeat after this long (default 24 hours)
+//   profile <name> <n> <time> <factor>... n steps, times ascending from 0
+//   od <from> <to|*> <vehicles/hour> [profile]
+class DemandSchedule
+{
+    vector<RateProfile> profiles;
+    vector<DemandFlow> flows;
+    double startClock;
+    double period;
+
+    IndexedDaryHeap<double> arrivals; // flow -> next arrival (simulation seconds)
+    long long generated;
+
+    double nextArrival(const DemandFlow &flow, double after, mt19937 &rng) const;
+
+public:
+    DemandSchedule();
+
+    bool loadFromFile(const string &fileName, const Graph &map, const ReachabilityIndex &reachability);
+    void clear();
+
+    void start(double now, mt19937 &rng); // Schedule every flow's first arrival after 'now'
+    // Append the flow index of every arrival up to 'now', in time order
+    void popDue(double now, mt19937 &rng, vector<int> &dueFlows);
+
+    bool empty() const { return flows.empty(); }
+    int getNumFlows() const { return static_cast<int>(flows.size()); }
+    const DemandFlow &getFlow(int index) const { return flows[index]; }
+    long long getGeneratedCount() const { return generated; }
+    double getRate(double time) const; // Total expected vehicles per second at simulation time 'time'
+
+    void printSummary() const;
+};
+
+#endif
@@ -3,19 +3,9 @@
 
 #include <queue>
 #include <vector>
-#include "Vehicle.h"
 #include "PriorityQueue.h"
 using namespace std;
 
-// Comparator for priority queue (higher priority -> higher urgency)
-struct ComparePriority
-{
-    bool operator()(Vehicle *a, Vehicle *b) const
-    {
-        return a->getPriority() < b->getPriority();
-    }
-};
-
 class EmergencyManager
 {
 private:
@@ -25,9 +15,10 @@ public:
     EmergencyManager();
 
     // Core Priority Queue Operations
-    void addEmergency(Vehicle *vehicle);
-    Vehicle *getNextEmergency();  // Get highest priority vehicle without removing
-    Vehicle *dispatchEmergency(); // Get and remove highest priority vehicle
+    void addEmergency(VehicleHandle vehicle, int vehicleID, int priority);
+    VehicleHandle getNextEmergency();  // Get highest priority vehicle without removing (null handle if none)
+    VehicleHandle dispatchEmergency(); // Get and remove highest priority vehicle (null handle if none)
+    void removeEmergency(VehicleHandle vehicle); // Vehicle left the simulation (arrived or undone)
 
     // Utility Functions
     bool hasEmergencies() const;
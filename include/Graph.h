@@ -5,8 +5,12 @@
 #include <unordered_map>
 #include <string>
 #include <limits>
+#include <memory>
+#include <cstdint>
 #include <SFML/System/Vector2.hpp>
-#include "PriorityQueue.h"
+#include "SearchWorkspace.h"
+#include "MappedArray.h"
+#include "MappedFile.h"
 using namespace std;
 
 struct Edge
@@ -28,11 +32,104 @@ struct Node
     float getY() const { return position.y; }
 };
 
+// One directed road as it was added (dense node indices); the CSR arrays are built from these
+struct RoadSegment
+{
+    int from;
+    int to;
+    double weight;
+
+    RoadSegment(int f, int t, double w) : from(f), to(t), weight(w) {}
+};
+
+// Traffic signal stored with a map (binary map files only; text maps use the built-in layout)
+struct SignalPlacement
+{
+    int node;            // External node ID
+    float greenDuration; // Seconds
+    float redDuration;
+    int automatic; // 1 = switches on its own, 0 = manual
+};
+
+// Fixed-cycle signal as seen by time-dependent routing, in seconds: green for 'green', then red for
+// 'red', over and over, 'phase' seconds into the cycle at time 0. red = 0 means no signal.
+struct SignalTiming
+{
+    double green;
+    double red;
+    double phase;
+
+    SignalTiming(double g = 0.0, double r = 0.0, double p = 0.0) : green(g), red(r), phase(p) {}
+
+    // Seconds a vehicle arriving at time t waits for green. t + waitAt(t) never decreases as t
+    // grows, so arriving earlier never means leaving later (the FIFO property)
+    double waitAt(double t) const;
+};
+
+// Travel times for time-dependent routing: seconds to cross each road and the signal at each node.
+// Signals hold vehicles at the nodes they pass through, not where a trip starts or ends.
+struct TravelTimeModel
+{
+    vector<double> edgeSeconds;   // By edge ID
+    vector<SignalTiming> signals; // By dense node index
+};
+
+// Search strategy for a route query
+enum class RouteAlgorithm
+{
+    DIJKSTRA,     // Uninformed, expands in all directions
+    ASTAR,        // Guided toward the destination by straight-line distance
+    BIDIRECTIONAL // Dijkstra from both ends at once, meeting in the middle
+};
+
+// Road network. Nodes are stored densely (index 0..N-1) with a remap from the external IDs used
+// in map files and paths. Roads are kept in compressed sparse row (CSR) form: the out-edges of
+// node u are edges [offsets[u], offsets[u + 1]) in the contiguous targets/weights arrays.
+// Edits mark the CSR stale and freeze() rebuilds it; loadFromFile() leaves the graph frozen.
+// A binary map file (see saveBinary()) is memory-mapped and its arrays are used in place.
 class Graph
 {
     int numNodes;
-    unordered_map<int, vector<Edge>> adjacencyList;
-    unordered_map<int, Node> nodes;
+    MappedArray<Node> nodes;           // dense index -> node (Node::ID is the external ID)
+    unordered_map<int, int> idToIndex; // external ID -> dense index
+    bool identityIDs;                  // true while every external ID equals its dense index
+
+    // Every directed road as added, in insertion order. Empty after a binary load (the file
+    // only has the CSR form) and out of date after setEdgeWeight(); rebuilt from the CSR before
+    // the next structural edit.
+    vector<RoadSegment> roads;
+    bool roadsStale;
+
+    // Bumped by every edit that can change a route, so cached routes know when they are stale
+    unsigned long long version;
+
+    // Frozen CSR form
+    bool csrDirty;
+    MappedArray<int> offsets;    // size numNodes + 1
+    MappedArray<int> targets;    // dense index of each edge's destination
+    MappedArray<double> weights; // weight of each edge
+
+    // Reverse CSR, built alongside: in-edges of node v are [reverseOffsets[v], reverseOffsets[v + 1])
+    MappedArray<int> reverseOffsets;
+    MappedArray<int> reverseSources; // dense index of each in-edge's origin
+    MappedArray<int> reverseEdges;   // matching forward edge ID (weights are read through it)
+
+    vector<SignalPlacement> signalPlacements;
+    shared_ptr<MappedFile> image; // Binary map the arrays above view, if any (shared by copies)
+
+    // A* heuristic: road weight per unit of straight-line distance between node positions.
+    // Admissible only while no road is cheaper than this per unit of length.
+    double heuristicScale;
+    bool autoHeuristicScale; // Recompute the largest admissible scale on every freeze()
+
+    // Scratch space for the non-const route queries, reused across calls
+    SearchWorkspace workspace;
+    SearchWorkspace reverseWorkspace; // Backward half of bidirectional queries
+
+    // Dijkstra from one node (over the reverse CSR if 'backward') until every target is settled
+    void settleTargets(int sourceIndex, const vector<int> &targetIndices, bool backward, SearchWorkspace &ws) const;
+    vector<int> buildPath(int endIndex, const SearchWorkspace &ws) const; // External IDs, start first
+    void restoreRoads(); // Refill 'roads' from the CSR after a binary load
 
 public:
     Graph(int n = 0);
@@ -40,21 +137,87 @@ public:
     // Core Graph Operations
     void addEdge(int from, int to, double weight, bool bidirect = true);
     void addNode(int id, float x = 0.0f, float y = 0.0f);
+    void freeze(); // Rebuild the CSR arrays if edits are pending
+    bool isFrozen() const { return !csrDirty; }
+    unsigned long long getVersion() const { return version; }
 
     // Finding shortest path using Dijkstra Algorithm
     vector<int> dijkstraAlgorithm(int start, int end);
+    // Same search with caller-owned scratch space (one per thread); the graph must already be frozen
+    vector<int> dijkstraAlgorithm(int start, int end, SearchWorkspace &ws) const;
+
+    // Shortest path with a selectable algorithm (same path cost either way)
+    vector<int> findRoute(int start, int end, RouteAlgorithm algorithm);
+    // Caller-owned scratch space; BIDIRECTIONAL needs the two-workspace form below
+    vector<int> findRoute(int start, int end, RouteAlgorithm algorithm, SearchWorkspace &ws) const;
+    vector<int> bidirectionalDijkstra(int start, int end, SearchWorkspace &forward, SearchWorkspace &backward) const;
+
+    // One-to-many: a single search from start, returning a path per destination ({} if unreachable)
+    vector<vector<int>> findRoutes(int start, const vector<int> &destinations);
+    vector<vector<int>> findRoutes(int start, const vector<int> &destinations, SearchWorkspace &ws) const;
+    // Many-to-many path costs, [origin][destination] (infinity if unreachable). Runs one search per
+    // origin, or one per destination over the reverse CSR when there are fewer destinations.
+    vector<vector<double>> costMatrix(const vector<int> &origins, const vector<int> &destinations);
+    vector<vector<double>> costMatrix(const vector<int> &origins, const vector<int> &destinations, SearchWorkspace &ws) const;
 
-    // Graph Utility Functions
+    // Earliest-arrival route leaving 'start' at time 'departure' (seconds), including the waits at
+    // signals on the way; 'arrival' gets the time at 'end'. Dijkstra over arrival times: with FIFO
+    // roads and signals, settling nodes in time order is still exact.
+    vector<int> timeDependentRoute(int start, int end, double departure, const TravelTimeModel &times, double &arrival);
+    vector<int> timeDependentRoute(int start, int end, double departure, const TravelTimeModel &times, double &arrival, SearchWorkspace &ws) const;
+    // Arrival time at the end of 'path' under the same model (infinity if the path isn't a route)
+    double routeArrival(const vector<int> &path, double departure, const TravelTimeModel &times) const;
+
+    // A* heuristic scale; setting it disables the automatic (admissible) scale
+    void setHeuristicScale(double scale);
+    double getHeuristicScale() const;
+    double computeAdmissibleScale() const; // min over roads of weight / straight-line length
+
+    // Graph Utility Functions (external IDs)
     bool nodeExists(int id) const;
-    const vector<Edge> &getNeighbours(int id) const;
+    vector<Edge> getNeighbours(int id) const;
     const Node &getNode(int id) const;
     int getNumNodes() const;
-    const unordered_map<int, Node> &getAllNodes() const;
+    int getNumEdges() const;
+    const MappedArray<Node> &getAllNodes() const; // Indexed by dense index
+
+    // Dense CSR access (valid while frozen). Nodes are 0..getNumNodes()-1, edges 0..getNumEdges()-1;
+    // edge IDs stay stable across weight changes but not across structural edits.
+    int indexOf(int id) const; // -1 if no such node
+    int idOf(int index) const { return nodes[index].ID; }
+    const Node &nodeAt(int index) const { return nodes[index]; }
+    int edgeBegin(int index) const { return offsets[index]; }
+    int edgeEnd(int index) const { return offsets[index + 1]; }
+    int edgeTarget(int edge) const { return targets[edge]; }
+    double edgeWeight(int edge) const { return weights[edge]; }
+    // Change one road's weight in place (no refreeze, edge IDs stay valid). Lowers the automatic
+    // A* scale if needed to stay admissible; false if the graph isn't frozen or there is no such edge.
+    bool setEdgeWeight(int edge, double weight);
+    int findEdge(int fromIndex, int toIndex) const; // -1 if there is no such road
+    // Hash of every node ID, road and weight (frozen graph), so files derived from a map can tell
+    // whether they still match it
+    uint64_t computeFingerprint() const;
+    int reverseBegin(int index) const { return reverseOffsets[index]; }
+    int reverseEnd(int index) const { return reverseOffsets[index + 1]; }
+    int reverseSource(int reverseEdge) const { return reverseSources[reverseEdge]; }
+    int reverseEdgeID(int reverseEdge) const { return reverseEdges[reverseEdge]; } // Forward edge ID
+
+    // Signals that come with the map; saved in binary map files, cleared by a text load
+    const vector<SignalPlacement> &getSignalPlacements() const;
+    void setSignalPlacements(const vector<SignalPlacement> &placements);
 
-    // File I/O
+    // File I/O. Text maps are the node count, then two-way "from to weight" roads, one-way
+    // "arc from to weight" roads and optional "node id x y" positions (other nodes get a grid
+    // layout). loadFromFile() also accepts binary maps (detected by their magic).
     bool loadFromFile(const string &fileName);
+    // Versioned binary image of the frozen graph: nodes, both CSRs, heuristic scale and signals,
+    // with a checksum. Loading maps the file and points the arrays into it, so there is no parsing
+    // and no per-node allocation. Skipping the checksum avoids reading the whole file up front.
+    bool saveBinary(const string &fileName) const;
+    bool loadBinary(const string &fileName, bool verifyChecksum = true);
+    bool isMapped() const { return image != nullptr; }
     // For Debugging
     void printGraph() const;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,118 @@
+#ifndef MAPPEDARRAY_H
+#define MAPPEDARRAY_H
+
+#include <vector>
+#include <cstddef>
+using namespace std;
+
+// Array that either owns its elements or views read-only ones that live elsewhere (a section of
+// a memory-mapped file). Reads cost the same either way; the first write to a viewed array copies
+// it into owned storage, so a mapped graph can still be edited. Copies of a view share the viewed
+// memory, which must outlive them.
+template <typename T>
+class MappedArray
+{
+    vector<T> owned;
+    const T *items; // owned.data() or the viewed memory
+    size_t count;
+
+    void sync()
+    {
+        items = owned.data();
+        count = owned.size();
+    }
+
+    bool isOwned() const { return items == owned.data(); }
+
+public:
+    MappedArray() : items(nullptr), count(0) {}
+
+    MappedArray(const MappedArray &other) : owned(other.owned), items(other.items), count(other.count)
+    {
+        if (other.isOwned())
+            sync();
+    }
+
+    MappedArray(MappedArray &&other) noexcept : items(other.items), count(other.count)
+    {
+        bool wasOwned = other.isOwned();
+        owned.swap(other.owned);
+        if (wasOwned)
+            sync();
+        other.sync();
+    }
+
+    MappedArray &operator=(MappedArray other)
+    {
+        bool wasOwned = other.isOwned();
+        owned.swap(other.owned);
+        items = other.items;
+        count = other.count;
+        if (wasOwned)
+            sync();
+        return *this;
+    }
+
+    // Point at 'n' elements owned by someone else (drops any owned storage)
+    void view(const T *data, size_t n)
+    {
+        owned.clear();
+        owned.shrink_to_fit();
+        items = data;
+        count = n;
+    }
+    bool isView() const { return !isOwned(); }
+
+    // Writable storage; copies viewed elements in first
+    T *mutableData()
+    {
+        if (!isOwned())
+        {
+            owned.assign(items, items + count);
+            sync();
+        }
+        return owned.data();
+    }
+
+    void assign(size_t n, const T &value)
+    {
+        owned.assign(n, value);
+        sync();
+    }
+
+    void resize(size_t n)
+    {
+        mutableData();
+        owned.resize(n);
+        sync();
+    }
+
+    void reserve(size_t n)
+    {
+        mutableData();
+        owned.reserve(n);
+        sync();
+    }
+
+    void push_back(const T &value)
+    {
+        mutableData();
+        owned.push_back(value);
+        sync();
+    }
+
+    void clear()
+    {
+        owned.clear();
+        sync();
+    }
+
+    const T &operator[](size_t i) const { return items[i]; }
+    const T *data() const { return items; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T *begin() const { return items; }
+    const T *end() const { return items + count; }
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+using namespace std;
+
+// Read-only memory mapping of a whole file (mmap on POSIX, a file mapping on Windows).
+// Large precomputed tables are used straight from the mapping, so loading them costs no copy and
+// the OS only pages in the parts that are actually read. The mapping lives until close() or
+// destruction, and the object can't be copied.
+class MappedFile
+{
+    const char *data;
+    size_t length;
+#ifdef _WIN32
+    void *fileHandle;
+    void *mappingHandle;
+#else
+    int fd;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const string &fileName); // false (with a message) if the file can't be mapped
+    void close();
+
+    bool isOpen() const { return data != nullptr; }
+    const char *getData() const { return data; }
+    size_t size() const { return length; }
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef NEXTHOPTABLE_H
+#define NEXTHOPTABLE_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "Graph.h"
+#include "MappedFile.h"
+using namespace std;
+
+// All-pairs next-hop table for small and medium maps: for every (node, destination) pair, the
+// next node on a shortest path. Routing then needs no search at all, only one lookup per hop.
+// build() runs one backward Dijkstra per destination, spread over every core; the finished table
+// can be saved and later memory-mapped straight from the file. Entries are 16-bit dense indices,
+// so a table takes 2 * N^2 bytes and maps are limited to MAX_NODES nodes.
+class NextHopTable
+{
+    const Graph *graph; // Map the table was built or loaded for (external ID lookups)
+    int numNodes;
+    int numEdges;
+    uint64_t fingerprint; // Hash of the map's roads and weights, checked when loading
+    vector<int> nodeIDs;  // dense index -> external ID
+
+    // Row per destination: hops[to * numNodes + from]. Points into ownedHops after build(),
+    // or into the mapped file after loadFromFile().
+    const uint16_t *hops;
+    vector<uint16_t> ownedHops;
+    MappedFile mapped;
+
+public:
+    static const int MAX_NODES = 16384;  // 512 MB of table
+    static const uint16_t NO_HOP = 0xFFFF; // Unreachable (or already there)
+
+    NextHopTable();
+
+    // Precompute for 'map' (must be frozen); threads <= 0 uses every hardware thread
+    bool build(const Graph &map, int threads = 0);
+    bool isReady() const;
+    void clear();
+
+    // Next dense index on the way from 'fromIndex' to 'toIndex', -1 if none
+    int nextHop(int fromIndex, int toIndex) const
+    {
+        uint16_t hop = hops[static_cast<size_t>(toIndex) * numNodes + fromIndex];
+        return hop == NO_HOP ? -1 : hop;
+    }
+
+    // Shortest path between external node IDs, by following next hops
+    vector<int> findRoute(int start, int end) const;
+
+    // File I/O (binary; only valid for the same map, including weights)
+    bool saveToFile(const string &fileName) const;
+    bool loadFromFile(const string &fileName, const Graph &map); // Memory-maps the table
+
+    int getNumNodes() const;
+    size_t getMemoryBytes() const; // Table size (mapped or owned)
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <vector>
+#include <thread>
+#include <functional>
+#include <algorithm>
+using namespace std;
+
+// Run body(begin, end, thread) over [0, count) split into one contiguous chunk per thread.
+// Small jobs run inline on the calling thread.
+inline void parallelFor(int count, int threads, const function<void(int, int, int)> &body)
+{
+    if (threads <= 1 || count < 64)
+    {
+        body(0, count, 0);
+        return;
+    }
+
+    vector<thread> workers;
+    int chunk = (count + threads - 1) / threads;
+    for (int t = 0; t < threads; t++)
+    {
+        int begin = t * chunk;
+        int end = min(count, begin + chunk);
+        if (begin >= end)
+            break;
+        workers.emplace_back(body, begin, end, t);
+    }
+
+    for (thread &worker : workers)
+        worker.join();
+}
+
+#endif
@@ -5,166 +5,229 @@
 #include <vector>
 #include <stdexcept>
 #include <utility>
-#include "../include/Vehicle.h"
+#include <functional>
+#include <algorithm>
+#include "VehicleHandle.h"
 using namespace std;
 
-/* Min-Heap Priority Queue for Dijkstra's Algorithm */
-// Stores pairs of (distance, node) where smallest distance has highest priority
-template <typename T>
-class MinHeapPQ
+/* Indexed d-ary Heap (used by Dijkstra and the emergency queue) */
+// Holds items 0..capacity-1 (dense node indices, vehicle slots, ...) at most once each, with a key.
+// A position map gives O(1) contains() and lets decreaseKey() move an item in place, so the heap
+// never holds stale duplicates. Compare(a, b) is true when key a should come out first; the default
+// less<Key> makes it a min-heap. A wider Arity means a shallower tree and siblings in one cache line.
+template <typename Key, typename Compare = less<Key>, int Arity = 4>
+class IndexedDaryHeap
 {
-    vector<T> heap;
+    struct Entry
+    {
+        Key key;
+        int item;
+    };
+
+    vector<Entry> heap;
+    vector<int> position; // item -> index in heap, -1 if not queued
+    Compare before;
 
-    int parent(int i) { return (i - 1) / 2; }
-    int leftChild(int i) { return 2 * i + 1; }
-    int rightChild(int i) { return 2 * i + 2; }
+    static int parent(int i) { return (i - 1) / Arity; }
+    static int firstChild(int i) { return Arity * i + 1; }
 
-    bool hasHigherPriority(const T &a, const T &b)
+    void place(int index, const Entry &entry)
     {
-        // For min-heap: smaller value = higher priority
-        return a.first < b.first;
+        heap[index] = entry;
+        position[entry.item] = index;
     }
 
-    void heapifyUp(int index)
+    void siftUp(int index)
     {
-        while (index > 0 && hasHigherPriority(heap[index], heap[parent(index)]))
+        Entry moving = heap[index];
+        while (index > 0 && before(moving.key, heap[parent(index)].key))
         {
-            swap(heap[index], heap[parent(index)]);
+            place(index, heap[parent(index)]);
             index = parent(index);
         }
+        place(index, moving);
     }
 
-    void heapifyDown(int index)
+    void siftDown(int index)
     {
         int size = heap.size();
-        int smallest = index;
-        int left = leftChild(index);
-        int right = rightChild(index);
-
-        if (left < size && hasHigherPriority(heap[left], heap[smallest]))
-            smallest = left;
-        if (right < size && hasHigherPriority(heap[right], heap[smallest]))
-            smallest = right;
+        Entry moving = heap[index];
 
-        if (smallest != index)
+        while (true)
         {
-            swap(heap[index], heap[smallest]);
-            heapifyDown(smallest);
+            int first = firstChild(index);
+            if (first >= size)
+                break;
+
+            // Pick the best of up to Arity children
+            int best = first;
+            int last = min(first + Arity, size);
+            for (int child = first + 1; child < last; child++)
+            {
+                if (before(heap[child].key, heap[best].key))
+                    best = child;
+            }
+
+            if (!before(heap[best].key, moving.key))
+                break;
+
+            place(index, heap[best]);
+            index = best;
         }
+        place(index, moving);
     }
 
 public:
-    MinHeapPQ() {}
+    IndexedDaryHeap(int capacity = 0) : position(capacity, -1) {}
 
-    void push(const T &value)
+    // Allow items up to capacity-1 (never shrinks)
+    void resize(int capacity)
     {
-        heap.push_back(value);
-        heapifyUp(heap.size() - 1);
+        if (capacity > static_cast<int>(position.size()))
+            position.resize(capacity, -1);
     }
 
-    T top() const
-    {
-        if (heap.empty())
-            throw runtime_error("MinHeapPQ: Cannot call top() on empty queue!");
-        return heap[0];
-    }
+    int capacity() const { return position.size(); }
+    bool contains(int item) const { return item >= 0 && item < static_cast<int>(position.size()) && position[item] != -1; }
 
-    void pop()
+    // Insert item, or move it to the new key if it is already queued
+    void push(int item, const Key &key)
     {
-        if (heap.empty())
-            throw runtime_error("MinHeapPQ: Cannot call pop() on empty queue!");
+        if (item < 0 || item >= static_cast<int>(position.size()))
+            throw out_of_range("IndexedDaryHeap: item outside the heap's capacity!");
 
-        heap[0] = heap.back();
-        heap.pop_back();
+        if (contains(item))
+        {
+            changeKey(item, key);
+            return;
+        }
 
-        if (!heap.empty())
-            heapifyDown(0);
+        heap.push_back({key, item});
+        position[item] = heap.size() - 1;
+        siftUp(heap.size() - 1);
     }
 
-    bool empty() const { return heap.size() == 0; }
-    int size() const { return heap.size(); }
-    void clear() { heap.clear(); }
-
-    // Print heap (for debugging)
-    void printHeap() const
+    // Key must not be worse than the current one (the Dijkstra relaxation case)
+    void decreaseKey(int item, const Key &key)
     {
-        cout << "Heap contents (size: " << heap.size() << "): ";
-        for (const auto &elem : heap)
-        {
-            cout << "(" << elem.first << "," << elem.second << ") ";
-        }
-        cout << endl;
+        int index = position[item];
+        heap[index].key = key;
+        siftUp(index);
     }
-};
 
-class MaxHeapPQ
-{
-    vector<Vehicle *> heap;
+    void changeKey(int item, const Key &key)
+    {
+        int index = position[item];
+        heap[index].key = key;
+        siftUp(index);
+        siftDown(position[item]);
+    }
 
-    int parent(int i) { return (i - 1) / 2; }
-    int leftChild(int i) { return 2 * i + 1; }
-    int rightChild(int i) { return 2 * i + 2; }
+    const Key &keyOf(int item) const { return heap[position[item]].key; }
 
-    bool hasHigherPriority(Vehicle *a, Vehicle *b)
+    int top() const
     {
-        if (a == nullptr || b == nullptr)
-            return false;
+        if (heap.empty())
+            throw runtime_error("IndexedDaryHeap: Cannot call top() on empty queue!");
+        return heap[0].item;
+    }
 
-        // Higher priority number = more urgent = higher priority
-        return a->getPriority() > b->getPriority();
+    const Key &topKey() const
+    {
+        if (heap.empty())
+            throw runtime_error("IndexedDaryHeap: Cannot call topKey() on empty queue!");
+        return heap[0].key;
     }
 
-    void heapifyUp(int index)
+    void pop()
     {
-        while (index > 0 && hasHigherPriority(heap[index], heap[parent(index)]))
+        if (heap.empty())
+            throw runtime_error("IndexedDaryHeap: Cannot call pop() on empty queue!");
+
+        position[heap[0].item] = -1;
+
+        Entry last = heap.back();
+        heap.pop_back();
+        if (!heap.empty())
         {
-            swap(heap[index], heap[parent(index)]);
-            index = parent(index);
+            heap[0] = last;
+            siftDown(0);
         }
     }
 
-    void heapifyDown(int index)
+    // Remove item wherever it is in the heap; no-op if it isn't queued
+    void erase(int item)
     {
-        int size = heap.size();
-        int largest = index;
-        int left = leftChild(index);
-        int right = rightChild(index);
+        if (!contains(item))
+            return;
+
+        int index = position[item];
+        position[item] = -1;
+
+        Entry last = heap.back();
+        heap.pop_back();
+        if (index == static_cast<int>(heap.size()))
+            return;
 
-        if (left < size && hasHigherPriority(heap[left], heap[largest]))
-            largest = left;
+        place(index, last);
+        siftUp(index);
+        siftDown(position[last.item]);
+    }
 
-        if (right < size && hasHigherPriority(heap[right], heap[largest]))
-            largest = right;
+    bool empty() const { return heap.size() == 0; }
+    int size() const { return heap.size(); }
+    int itemAt(int index) const { return heap[index].item; } // Heap order, for debugging output
 
-        if (largest != index)
-        {
-            swap(heap[index], heap[largest]);
-            heapifyDown(largest);
-        }
+    // O(size), not O(capacity): only the queued items need their positions reset
+    void clear()
+    {
+        for (const Entry &entry : heap)
+            position[entry.item] = -1;
+        heap.clear();
     }
+};
+
+/* Max-Heap Priority Queue for Emergency Vehicles */
+// Stores a handle to each emergency vehicle with its priority (ID kept for logging)
+struct EmergencyEntry
+{
+    VehicleHandle vehicle;
+    int vehicleID;
+    int priority;
+
+    EmergencyEntry(VehicleHandle handle = VehicleHandle(), int id = -1, int p = 0) : vehicle(handle), vehicleID(id), priority(p) {}
+};
+
+// Keyed by the vehicle's slot in the VehicleStore, so each slot is queued at most once: a vehicle that
+// reuses the slot of a stale entry replaces it instead of piling up behind it
+class MaxHeapPQ
+{
+    IndexedDaryHeap<int, greater<int>> heap; // slot -> priority, higher number = more urgent
+    vector<EmergencyEntry> entries;          // slot -> full entry
 
 public:
     MaxHeapPQ() {}
 
-    void push(Vehicle *vehicle)
+    void push(const EmergencyEntry &entry)
     {
-        if (vehicle == nullptr)
+        int slot = entry.vehicle.index;
+        if (slot >= heap.capacity())
         {
-            cout << "Error: Cannot add null vehicle to heap!" << std::endl;
-            return;
+            heap.resize(max(slot + 1, heap.capacity() * 2));
+            entries.resize(heap.capacity());
         }
 
-        heap.push_back(vehicle);
-        heapifyUp(heap.size() - 1);
+        entries[slot] = entry;
+        heap.push(slot, entry.priority);
 
-        cout << "Vehicle " << vehicle->getID() << " (Priority: " << vehicle->getPriority() << ") added to heap" << endl;
+        cout << "Vehicle " << entry.vehicleID << " (Priority: " << entry.priority << ") added to heap" << endl;
     }
 
-    Vehicle *top() const
+    EmergencyEntry top() const
     {
         if (heap.empty())
             throw runtime_error("MaxHeapPQ: Cannot call top() on empty queue!");
-        return heap[0];
+        return entries[heap.top()];
     }
 
     void pop()
@@ -172,16 +235,24 @@ public:
         if (heap.empty())
             throw runtime_error("MaxHeapPQ: Cannot call pop() on empty queue!");
 
-        cout << "Removing Vehicle " << heap[0]->getID() << " (Priority: " << heap[0]->getPriority() << ")" << endl;
+        const EmergencyEntry &entry = entries[heap.top()];
+        cout << "Removing Vehicle " << entry.vehicleID << " (Priority: " << entry.priority << ")" << endl;
 
-        heap[0] = heap.back();
-        heap.pop_back();
+        heap.pop();
+    }
 
-        if (!heap.empty())
-            heapifyDown(0);
+    // Drop a vehicle's entry (e.g. when it leaves the simulation); false if it wasn't queued
+    bool erase(VehicleHandle vehicle)
+    {
+        int slot = vehicle.index;
+        if (!heap.contains(slot) || entries[slot].vehicle != vehicle)
+            return false;
+
+        heap.erase(slot);
+        return true;
     }
 
-    bool empty() const { return heap.size() == 0; }
+    bool empty() const { return heap.empty(); }
     int size() const { return heap.size(); }
     void clear() { heap.clear(); }
 
@@ -196,12 +267,13 @@ public:
 
         cout << endl << "=== MAX HEAP STRUCTURE ===" << endl;
         cout << "Size: " << heap.size() << endl;
-        cout << "Root (Highest Priority): Vehicle " << heap[0]->getID() << " (Priority: " << heap[0]->getPriority() << ")" << endl;
+        cout << "Root (Highest Priority): Vehicle " << top().vehicleID << " (Priority: " << top().priority << ")" << endl;
 
         cout << endl << "All vehicles in heap order:" << endl;
         for (int i = 0; i < heap.size(); i++)
         {
-            cout << "  [" << i << "] Vehicle " << heap[i]->getID() << " (Priority: " << heap[i]->getPriority() << ")" << endl;
+            const EmergencyEntry &entry = entries[heap.itemAt(i)];
+            cout << "  [" << i << "] Vehicle " << entry.vehicleID << " (Priority: " << entry.priority << ")" << endl;
         }
         cout << "==========================\n"
              << endl;
@@ -24,6 +24,8 @@ class Queue
 
 public:
     Queue();
+    Queue(const Queue<T> &other);
+    Queue<T> &operator=(const Queue<T> &other);
 
     void push(T val);
     void pop();
@@ -37,6 +39,28 @@ public:
 template <typename T>
 Queue<T>::Queue() : Size(0), start(nullptr), end(nullptr) {}
 
+template <typename T>
+Queue<T>::Queue(const Queue<T> &other) : Size(0), start(nullptr), end(nullptr)
+{
+    for (QueueListNode<T> *temp = other.start; temp != nullptr; temp = temp->next)
+        push(temp->data);
+}
+
+template <typename T>
+Queue<T> &Queue<T>::operator=(const Queue<T> &other)
+{
+    if (this == &other)
+        return *this;
+
+    while (!empty())
+        pop();
+
+    for (QueueListNode<T> *temp = other.start; temp != nullptr; temp = temp->next)
+        push(temp->data);
+
+    return *this;
+}
+
 template <typename T>
 void Queue<T>::push(T val)
 {
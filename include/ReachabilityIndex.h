@@ -0,0 +1,44 @@
+#ifndef REACHABILITYINDEX_H
+#define REACHABILITYINDEX_H
+
+#include <vector>
+#include "Graph.h"
+using namespace std;
+
+// Strongly connected components of a frozen map (iterative Tarjan, O(V + E)), plus the condensed
+// component graph. Any two nodes in the same component can reach each other, so picking both ends
+// of a trip from one component never wastes a search on an unroutable pair. Components are
+// numbered in the order Tarjan completes them, which is a reverse topological order: a road from
+// component a to a different component b always has a > b. Works on dense node indices.
+class ReachabilityIndex
+{
+    vector<int> componentOf;    // dense index -> component
+    vector<int> componentStart; // members of c: componentNodes[componentStart[c] .. componentStart[c + 1])
+    vector<int> componentNodes; // dense indices, ascending within each component
+
+    // Condensed graph: distinct roads between components, CSR by source component
+    vector<int> dagOffsets;
+    vector<int> dagTargets;
+
+    int largestComponent;
+
+public:
+    ReachabilityIndex();
+
+    void build(const Graph &map);
+    void clear();
+
+    int getNumComponents() const { return static_cast<int>(componentStart.size()) - 1; }
+    int componentOfNode(int index) const { return componentOf[index]; }
+    int getComponentSize(int component) const { return componentStart[component + 1] - componentStart[component]; }
+    int memberAt(int component, int k) const { return componentNodes[componentStart[component] + k]; } // k-th member, ascending
+    int getLargestComponent() const { return largestComponent; } // -1 if the map is empty
+
+    bool sameComponent(int fromIndex, int toIndex) const { return componentOf[fromIndex] == componentOf[toIndex]; }
+    // Whether any route exists; O(1) for the same component or an impossible order, else a walk of the condensed graph
+    bool canReach(int fromIndex, int toIndex) const;
+
+    void printSummary() const;
+};
+
+#endif
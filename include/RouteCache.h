@@ -0,0 +1,62 @@
+#ifndef ROUTECACHE_H
+#define ROUTECACHE_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+using namespace std;
+
+// Bounded cache of routes keyed by (origin, destination), with CLOCK (second-chance) eviction.
+// Paths are immutable and shared, so a hit hands out the stored path without copying or searching.
+// Every lookup carries the graph's version; if it differs from the version the cached routes were
+// computed on, the whole cache is dropped first. Unreachable pairs are cached too (as empty paths).
+class RouteCache
+{
+    struct Entry
+    {
+        uint64_t key;
+        shared_ptr<const vector<int>> path;
+        bool referenced; // Set on every hit, cleared as the clock hand passes
+    };
+
+    vector<Entry> entries;
+    unordered_map<uint64_t, int> slotOf; // key -> index into entries
+    int capacity;
+    int hand; // Next entry the clock looks at when something has to go
+    unsigned long long graphVersion;
+
+    // Counters
+    long long hits;
+    long long misses;
+    long long evictions;
+    long long invalidations; // Times the cache was dropped because the graph changed
+    long long storedNodes;   // Node IDs held across all cached paths
+
+    static uint64_t makeKey(int origin, int destination);
+    void checkVersion(unsigned long long version);
+
+public:
+    RouteCache(int maxEntries = 4096);
+
+    // nullptr on a miss
+    shared_ptr<const vector<int>> find(int origin, int destination, unsigned long long version);
+    // Stores a freshly computed path and returns the shared copy (not stored if capacity is 0)
+    shared_ptr<const vector<int>> insert(int origin, int destination, unsigned long long version, vector<int> path);
+
+    void clear(); // Drops every route, keeps the counters
+    void setCapacity(int maxEntries);
+
+    int getSize() const;
+    int getCapacity() const;
+    long long getHits() const;
+    long long getMisses() const;
+    long long getEvictions() const;
+    long long getInvalidations() const;
+    double getHitRate() const;     // hits / lookups, 0 before the first lookup
+    size_t getMemoryBytes() const; // Approximate heap footprint of the cached routes
+
+    void printStats() const;
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef ROUTEPOOL_H
+#define ROUTEPOOL_H
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+using namespace std;
+
+// Interned (hash-consed) routes: every distinct path is stored once, back to back in one arena,
+// and vehicles refer to it by a small route ID. Routes are reference counted; a route whose
+// count drops to zero gives its ID back, and its arena space is reclaimed by an occasional
+// compaction. Route IDs never move, so holders don't notice the compaction.
+class RoutePool
+{
+    vector<int> arena;         // Node IDs of every route, back to back
+    vector<int> routeStarts;   // route ID -> offset into the arena
+    vector<int> routeLengths;  // route ID -> number of nodes
+    vector<int> refCounts;     // route ID -> current holders, 0 for a free ID
+    vector<uint64_t> hashes;   // route ID -> content hash
+    vector<long long> uses;    // route ID -> times it was handed out since it was created
+
+    unordered_multimap<uint64_t, int> byHash; // content hash -> live route IDs with that hash
+    vector<int> freeIDs;
+    int liveRoutes;
+    int deadNodes; // Arena entries still held by released routes
+
+    static uint64_t hashPath(const vector<int> &path);
+    bool matches(int route, const vector<int> &path) const;
+    void compact();
+
+public:
+    RoutePool();
+
+    int intern(const vector<int> &path); // ID of the stored copy (one more holder); -1 for an empty path
+    void acquire(int route);             // One more holder of an existing route
+    void release(int route);             // One holder fewer; the route is freed at zero
+
+    // Route contents (valid until the next intern, which may grow the arena)
+    int length(int route) const { return routeLengths[route]; }
+    int nodeAt(int route, int i) const { return arena[routeStarts[route] + i]; }
+    int front(int route) const { return arena[routeStarts[route]]; }
+    int back(int route) const { return arena[routeStarts[route] + routeLengths[route] - 1]; }
+    vector<int> getPath(int route) const;
+
+    // Route distribution
+    int getRouteCount() const; // Live routes
+    int getHolders(int route) const;
+    long long getUses(int route) const;
+    int getArenaSize() const;
+    size_t getMemoryBytes() const;
+
+    void clear();
+    void printStats() const;
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef SEARCHWORKSPACE_H
+#define SEARCHWORKSPACE_H
+
+#include <vector>
+#include <limits>
+#include "PriorityQueue.h"
+using namespace std;
+
+// Reusable scratch state for shortest-path searches over dense node indices.
+// Each search gets a new stamp; a node's dist/parent are only valid if its stamp matches, so
+// starting a search costs O(1) and a query only touches the nodes it actually visits.
+// One workspace serves one search at a time - give each thread its own.
+class SearchWorkspace
+{
+    // Kept together so the stamp check and the distance read hit the same cache line
+    struct Label
+    {
+        double dist;
+        int parent;
+        unsigned int stamp;
+    };
+
+    vector<Label> labels;
+    vector<unsigned int> targetStamps; // Node is a target of the current search if its stamp matches
+    unsigned int currentStamp;
+    int settledCount; // Nodes expanded by the current search
+
+    IndexedDaryHeap<double> heap; // node -> tentative distance; keeps its capacity between searches
+
+public:
+    SearchWorkspace();
+
+    // Start a new search over a graph with numNodes nodes (grows the arrays if the graph grew)
+    void begin(int numNodes);
+
+    double distance(int node) const { return labels[node].stamp == currentStamp ? labels[node].dist : numeric_limits<double>::infinity(); }
+    int parentOf(int node) const { return labels[node].stamp == currentStamp ? labels[node].parent : -1; }
+
+    void setDistance(int node, double d, int p) { labels[node] = {d, p, currentStamp}; }
+
+    // Targets of a one-to-many search; markTarget() is false if the node was already marked
+    bool markTarget(int node);
+    bool isTarget(int node) const { return targetStamps[node] == currentStamp; }
+
+    IndexedDaryHeap<double> &queue() { return heap; }
+
+    void countSettled() { settledCount++; }
+    int getSettledCount() const { return settledCount; }
+    int capacity() const { return labels.size(); }
+};
+
+#endif
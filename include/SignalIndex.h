@@ -0,0 +1,26 @@
+#ifndef SIGNALINDEX_H
+#define SIGNALINDEX_H
+
+#include <vector>
+#include "TrafficSignal.h"
+#include "Graph.h"
+using namespace std;
+
+// Dense node -> signal lookup table, so finding the signal at an intersection is O(1)
+// instead of a scan over every signal. Keyed by the map's dense node index (Graph::indexOf), so
+// sparse external IDs work too. Must be rebuilt whenever the signal list or the map changes.
+class SignalIndex
+{
+    vector<int> signalAtNode; // dense node index -> index into the signal vector, -1 if the node has no signal
+
+public:
+    SignalIndex();
+
+    void rebuild(const vector<TrafficSignal> &signals, const Graph &map);
+    void clear();
+
+    int find(int nodeIndex) const; // Index of the signal at a dense node index, -1 if none
+    bool has(int nodeIndex) const;
+};
+
+#endif
@@ -3,29 +3,18 @@
 
 #include <SFML/Graphics.hpp>
 #include <vector>
-#include <unordered_map>
-#include "Graph.h"
-#include "Vehicle.h"
-#include "TrafficSignal.h"
-#include "ActionStack.h"
-#include "EmergencyManager.h"
-#include "Analytics.h"
+#include "SimulationEngine.h"
 using namespace std;
 
+// Windowed front-end: owns the SFML window and assets, forwards input to the engine and draws its state
 class Simulation
 {
-    // Core components
-    Graph cityMap;
-    vector<Vehicle> vehicles;
-    vector<TrafficSignal> signals;
-    ActionStack undoStack;
-    EmergencyManager emergencyMgr;
-    Analytics analytics;
+    // Core simulation (no rendering)
+    SimulationEngine engine;
 
     // SFML Window
     sf::RenderWindow window;
     sf::Clock clock;
-    float totalTime;
 
     // Static assets (loaded once, shared by all vehicles)
     static sf::Font font;
@@ -44,28 +33,23 @@ class Simulation
     static bool redLightLoaded;
     static bool greenLightLoaded;
 
-    // Simulation state
-    int nextVehicleID;
-    vector<int> vehiclesToRemove;
     bool isRunning;
 
+    // Camera: fitted to the map when it doesn't fit the window, zoomed with the mouse wheel.
+    // Only nodes in view (plus the longest road's length) are drawn.
+    sf::View mapView;
+    float cullMargin;
+    vector<int> visibleNodes; // Dense indices, refreshed every frame
+
     // Helper methods
     void loadAssets();
-    void initializeSignals();
-    void spawnInitialVehicles();
-    bool hasSignal(int nodeID) const;
+    void fitViewToMap();
+    void findVisibleNodes();
 
     // Core game loop methods
     void handleInput();
-    void update(float deltaTime);
     void render();
 
-    // Input handlers
-    void toggleSignal(int signalIndex);
-    void spawnRegularVehicle();
-    void spawnEmergencyVehicle();
-    void undoLastAction();
-
     // Rendering methods
     void drawRoads();
     void drawIntersections();
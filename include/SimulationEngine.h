@@ -0,0 +1,200 @@
+#ifndef SIMULATIONENGINE_H
+#define SIMULATIONENGINE_H
+
+#include <vector>
+#include <string>
+#include <random>
+#include "Graph.h"
+#include "ContractionHierarchy.h"
+#include "NextHopTable.h"
+#include "RouteCache.h"
+#include "Vehicle.h"
+#include "VehicleStore.h"
+#include "TrafficSignal.h"
+#include "SignalIndex.h"
+#include "SpatialGrid.h"
+#include "ReachabilityIndex.h"
+#include "DemandSampler.h"
+#include "DemandSchedule.h"
+#include "CongestionModel.h"
+#include "ActionStack.h"
+#include "EmergencyManager.h"
+#include "Analytics.h"
+using namespace std;
+
+// Where spawned vehicles' routes come from
+enum class RouteSource
+{
+    SEARCH,        // Graph search with the selected RouteAlgorithm
+    HIERARCHY,     // Contraction hierarchy queries
+    NEXT_HOP_TABLE // All-pairs next-hop lookups
+};
+
+// Core simulation state and rules, with no dependency on SFML graphics.
+// Used by the windowed Simulation front-end and by the headless runner.
+class SimulationEngine
+{
+    // Core components
+    Graph cityMap;
+    SpatialGrid nodeGrid; // Node positions, rebuilt with the map
+    ReachabilityIndex reachability; // Strongly connected components, so spawns only pick routable pairs
+    DemandSampler demand; // Weighted trip ends over the components; signal nodes are excluded as origins
+    vector<int> excludedOrigins; // Dense indices currently excluded in 'demand'
+    VehicleStore vehicles; // Column-wise (SoA) vehicle storage
+    vector<TrafficSignal> signals;
+    SignalIndex signalIndex; // node -> signal, rebuilt whenever 'signals' changes
+    ActionStack undoStack;
+    EmergencyManager emergencyMgr;
+    Analytics analytics;
+
+    float totalTime;
+
+    // Fixed-timestep stepping
+    float tickSize;    // Simulated seconds per tick
+    float accumulator; // Frame time received but not yet simulated
+    long long tickCount;
+
+    // Per-instance random source, so a given seed always replays the same run
+    mt19937 rng;
+    int randomInt(int maxExclusive); // Uniform in [0, maxExclusive)
+    int randomSpawnNode();                   // Weighted origin without a signal that can reach some other node, -1 if none
+    int randomDestination(int startNode);    // Weighted node in the start's component (so surely reachable), -1 if none
+    void updateSpawnExclusions();            // Called whenever 'signals' changes; also drops the cached signal phases
+
+    // OD demand: Poisson arrivals popped every tick and routed in one batch per start node
+    DemandSchedule demandSchedule;
+    vector<int> dueFlows;             // Scratch, reused every tick
+    vector<pair<int, int>> dueTrips;  // (start, end), same
+    void spawnDueTrips();
+    int spawnTrips(int startNode, const vector<int> &endNodes); // Routes found together; returns how many spawned
+
+    // Live road weights from observed congestion. Every weight update queues the vehicles whose
+    // remaining route got noticeably dearer; a few of them are rerouted each tick.
+    CongestionModel congestion;
+    bool liveWeights;
+    float weightInterval; // Seconds between weight updates
+    double nextCongestionSample;
+    double nextWeightUpdate;
+    int reroutesPerTick;
+    vector<VehicleHandle> rerouteQueue;
+    size_t rerouteHead; // Next entry of rerouteQueue to process
+    vector<pair<int, int>> rerouteStarts; // (new start node, row), scratch for each tick's share
+    vector<pair<int, double>> slowerEdges; // (edge, weight increase) from the last weight update
+    vector<double> edgeIncrease;  // By edge ID, 0 unless in slowerEdges
+    vector<char> hasSlowerEdge;   // By dense node index: some road out of it got slower
+    long long rerouteCount;
+    int currentEdge(int row) const; // Road the vehicle is on (or queued at the end of), -1 before its first move
+    void sampleCongestion();
+    void updateLiveWeights();
+    void processReroutes();
+    double pathCost(const vector<int> &path, int from) const; // Current weight of the path from its from-th node on
+
+    // Expected travel times, for ETAs and signal-aware routing: 'roadTime' per road (scaled like its
+    // weight under live weights) and every signal's cycle as it stands. The road times follow the map
+    // version; the signal phases are read again at most once per tick.
+    double roadTime; // Seconds a regular vehicle takes per road at this tick size
+    TravelTimeModel travelTimes;
+    vector<int> timedSignalNodes;          // Dense indices with a timing in travelTimes.signals
+    long long travelTimesTick;             // Tick the phases were read at, -1 if never
+    unsigned long long travelTimesVersion; // Map version the road times were taken from
+    bool signalAwareRouting;
+    void refreshTravelTimes();
+    double departureTime() const; // When a vehicle spawned now effectively leaves its start
+    vector<int> signalAwareRoute(int startNode, int endNode); // Earliest arrival leaving now ({} if none)
+
+    // Route search used for spawned vehicles; a hierarchy or next-hop table takes over once enabled.
+    // Results are cached per (start, end) until the map changes.
+    RouteAlgorithm routeAlgorithm;
+    ContractionHierarchy hierarchy;
+    NextHopTable nextHops;
+    RouteSource routeSource;
+    RouteCache routeCache;
+    unsigned long long routeTableVersion; // Map version when the hierarchy or table was enabled
+    unsigned long long routeCacheVersion() const; // What cached routes are checked against
+    vector<int> computeRoute(int startNode, int endNode); // Uncached, from the current source
+    shared_ptr<const vector<int>> findRoute(int startNode, int endNode);
+    // Routes from one start to many ends; cache misses share a single one-to-many search
+    vector<shared_ptr<const vector<int>>> findRoutes(int startNode, const vector<int> &endNodes);
+    void addRegularVehicle(int startNode, int endNode, const vector<int> &path);
+
+    // Simulation state
+    int nextVehicleID;
+    vector<VehicleHandle> vehiclesToRemove; // Undone spawns
+    vector<VehicleHandle> vehiclesToRetire; // Arrived this tick
+    vector<int> reachedRows; // Scratch list reused by every tick
+
+    void update(float deltaTime);
+
+public:
+    SimulationEngine(unsigned int seed, float tick = 1.0f / 60.0f);
+
+    // Setup
+    bool loadMap(const string &filename);
+    void initializeSignals();     // The map's own signals, or the built-in layout on the demo map
+    void spawnInitialVehicles();  // Three fixed trips, demo map only
+    bool isDemoMap() const;       // Has the 12 nodes the built-in signals and trips refer to
+    bool hasSignal(int nodeID) const;
+    void addSignal(const TrafficSignal &signal);
+    bool removeSignal(int signalID); // false if no signal has that ID
+    bool setSpawnWeights(int nodeID, double originWeight, double destinationWeight); // Demand at a node (default 1, 1); false if no such node
+    bool loadDemand(const string &filename); // OD matrix with rate profiles (see DemandSchedule.h); arrivals start now
+
+    // Stepping
+    void step();                  // Advance exactly one tick
+    int advance(float frameTime); // Feed real elapsed time, runs as many whole ticks as fit (returns count)
+    void setTickSize(float tick); // Only allowed before the first tick
+    float getTickSize() const;
+    long long getTickCount() const;
+
+    // Routing
+    void setRouteAlgorithm(RouteAlgorithm algorithm);
+    RouteAlgorithm getRouteAlgorithm() const;
+    bool enableHierarchy(const string &cacheFile = ""); // Load from cacheFile if it matches the map, else build (and save there)
+    bool enableNextHopTable(const string &cacheFile = ""); // Same, for the all-pairs table (the file is memory-mapped)
+    RouteSource getRouteSource() const;
+    void setRouteCacheCapacity(int maxRoutes);         // 0 turns the cache off
+    // Feed observed congestion back into road weights every 'updateInterval' seconds and reroute
+    // affected vehicles, at most 'maxReroutesPerTick' per tick. Only graph search sees the live
+    // weights; a hierarchy or next-hop table keeps routing on the weights it was built with, so
+    // nothing is rerouted and its cached routes stay valid.
+    void enableLiveWeights(float updateInterval = 10.0f, int maxReroutesPerTick = 64);
+    // Signal-aware routing: regular vehicles take the earliest-arrival route given the phase of every
+    // signal when they leave, instead of the cheapest by weight. Graph search only; emergency
+    // vehicles ignore signals and reroutes compare weights, so both keep the weighted routes.
+    void setSignalAwareRouting(bool enabled);
+    bool hasSignalAwareRouting() const;
+    bool hasLiveWeights() const;
+    const CongestionModel &getCongestion() const;
+    long long getRerouteCount() const;
+    const RouteCache &getRouteCache() const;
+
+    // Commands
+    void toggleSignal(int signalIndex);
+    void spawnRegularVehicle();
+    void spawnEmergencyVehicle();
+    int spawnBurst(int startNode, int count); // 'count' regular vehicles from one node (returns how many got a route)
+    int spawnRandomBurst(int count);          // Same, from a random node without a signal
+    int spawnBurstAt(float x, float y, int count); // Same, from the node closest to (x, y)
+    void undoLastAction();
+
+    // Read-only state (for rendering and reporting)
+    const Graph &getMap() const;
+    const SpatialGrid &getNodeGrid() const;
+    const ReachabilityIndex &getReachability() const;
+    const DemandSchedule &getDemandSchedule() const;
+    int nearestNode(float x, float y, float maxDistance = numeric_limits<float>::infinity()) const; // Node ID, -1 if none
+    const VehicleStore &getVehicles() const;
+    const vector<TrafficSignal> &getSignals() const;
+    float getTotalTime() const;
+    int getUndoCount() const;
+    int getSignalCount() const;
+    int getArrivedCount() const; // Retired vehicles (completed trips)
+
+    // Analytics
+    void finalizeAnalytics();
+    bool saveAnalytics(const string &filename);
+    void printAnalytics() const;
+    void printEmergencyQueue() const;
+};
+
+#endif
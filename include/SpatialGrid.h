@@ -0,0 +1,49 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <vector>
+#include <limits>
+#include <SFML/System/Vector2.hpp>
+#include "Graph.h"
+using namespace std;
+
+// Uniform grid over a map's node positions, for nearest-node and range queries (camera culling,
+// click picking, spawning by coordinates). Cells are sized for about two nodes each and stored
+// CSR-style: cell c holds cellNodes[cellStart[c] .. cellStart[c + 1]). Results are dense node
+// indices. Must be rebuilt whenever nodes are added or moved.
+class SpatialGrid
+{
+    sf::Vector2<float> boundsMin;
+    sf::Vector2<float> boundsMax;
+    float cellSize;
+    int columns;
+    int rows;
+
+    vector<int> cellStart;                   // size columns * rows + 1
+    vector<int> cellNodes;                   // dense node index, grouped by cell
+    vector<sf::Vector2<float>> cellPositions; // matching positions, so queries read one array
+
+    int columnOf(float x) const; // Clamped to the grid
+    int rowOf(float y) const;
+
+public:
+    SpatialGrid();
+
+    void build(const Graph &map);
+    void clear();
+    bool empty() const { return cellNodes.empty(); }
+
+    // Closest node to 'point', -1 if the grid is empty or nothing lies within maxDistance
+    int nearest(sf::Vector2<float> point, float maxDistance = numeric_limits<float>::infinity()) const;
+
+    // Nodes inside the rectangle [left, right] x [top, bottom], or within 'radius' of 'center' (appended to 'out')
+    void queryRange(float left, float top, float right, float bottom, vector<int> &out) const;
+    void queryRadius(sf::Vector2<float> center, float radius, vector<int> &out) const;
+
+    sf::Vector2<float> getBoundsMin() const { return boundsMin; } // Bounding box of all nodes
+    sf::Vector2<float> getBoundsMax() const { return boundsMax; }
+    float getCellSize() const { return cellSize; }
+    size_t getMemoryBytes() const;
+};
+
+#endif
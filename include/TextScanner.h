@@ -0,0 +1,40 @@
+#ifndef TEXTSCANNER_H
+#define TEXTSCANNER_H
+
+#include <string>
+using namespace std;
+
+// Whitespace-separated token reader over an in-memory text buffer (typically a MappedFile).
+// Numbers are parsed with std::from_chars, so there is no stream or locale overhead, and the
+// scanner keeps track of the line and column of the next token for error messages.
+class TextScanner
+{
+    const char *cursor;
+    const char *end;
+    const char *lineStart;
+    int line;
+
+    void skipWhitespace();
+    const char *tokenEnd() const; // End of the token starting at cursor
+
+public:
+    TextScanner(const char *begin, const char *finish);
+
+    bool atEnd();     // True once only whitespace is left
+    bool atComment(); // True if the next token starts with '#'
+
+    // Each reads one whole token; on failure nothing is consumed
+    bool readInt(int &value);
+    bool readDouble(double &value);
+    bool readWord(string &word);
+
+    void skipLine(); // Drop the rest of the current line
+
+    int getLine() const;   // 1-based position of the next token
+    int getColumn() const;
+    string peekToken() const; // The next token as text (for error messages), "end of file" if none
+
+    static long long countLines(const char *begin, const char *finish); // Newlines, plus one for an unterminated last line
+};
+
+#endif
@@ -4,8 +4,7 @@
 #include "Queue.h"
 #include <vector>
 #include <SFML/System/Vector2.hpp>
-#include <SFML/Graphics/Color.hpp>
-#include "Vehicle.h"
+#include "VehicleStore.h"
 using namespace std;
 
 enum class SignalState
@@ -22,7 +21,7 @@ private:
     SignalState state;
 
     sf::Vector2<float> position;
-    Queue<Vehicle *> waitingQueue; // Queue of cars waiting at red light
+    Queue<VehicleHandle> waitingQueue; // Cars waiting at red light
     float timer;
     float greenDuration; // How long green light lasts (seconds)
     float redDuration;   // How long red light lasts (seconds)
@@ -32,15 +31,15 @@ public:
     // Constructor
     TrafficSignal(int id, int nodeID, const sf::Vector2<float> &pos, float greenTime = 5.0f, float redTime = 5.0f, bool automatic = true);
 
-    // Signal control
-    void toggleLight();
-    void updateTimer(float deltaTime); // for automatic switch of signals
-    void switchState();
+    // Signal control (the vehicle store is needed to release waiting cars)
+    void toggleLight(VehicleStore &vehicles);
+    void updateTimer(float deltaTime, VehicleStore &vehicles); // for automatic switch of signals
+    void switchState(VehicleStore &vehicles);
 
     // Queue management
-    void addVehicleToQueue(Vehicle *car);
-    Vehicle *dequeueVehicle();
-    void releaseAllVehicles();
+    void addVehicleToQueue(VehicleHandle car, VehicleStore &vehicles);
+    VehicleHandle dequeueVehicle(VehicleStore &vehicles); // Null handle if nothing was released
+    void releaseAllVehicles(VehicleStore &vehicles);
     bool isQueueEmpty() const;
     int getQueueSize() const;
 
@@ -49,12 +48,13 @@ public:
     int getIntersectionID() const;
     SignalState getState() const;
     sf::Vector2<float> getPosition() const;
-    sf::Color getColor() const;
     float getTimer() const;
+    float getGreenDuration() const;
+    float getRedDuration() const;
     bool isAutoMode() const;
 
     // Setters
-    void setState(SignalState newState);
+    void setState(SignalState newState, VehicleStore &vehicles);
     void setAutoMode(bool automatic);
     void setGreenDuration(float duration);
     void setRedDuration(float duration);
@@ -51,7 +51,10 @@ public:
     const vector<int> &getPath() const;
     double getSpeed() const;
     sf::Vector2<float> getPosition() const;
+    sf::Vector2<float> getStartPosition() const;
+    sf::Vector2<float> getTargetPosition() const;
     float getInterpolation() const;
+    int getCurrentPathIndex() const;
     int getPriority() const;
     bool isEmergency() const;
 
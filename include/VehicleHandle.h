@@ -0,0 +1,25 @@
+#ifndef VEHICLEHANDLE_H
+#define VEHICLEHANDLE_H
+
+#include <cstdint>
+
+// Stable reference to a vehicle in the VehicleStore: a slot index plus the generation of that slot.
+// When a vehicle is removed its slot's generation is bumped, so old handles fail lookup instead of
+// pointing at whichever vehicle reuses the slot.
+struct VehicleHandle
+{
+    static const uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+    uint32_t index;
+    uint32_t generation;
+
+    VehicleHandle() : index(INVALID_INDEX), generation(0) {}
+    VehicleHandle(uint32_t idx, uint32_t gen) : index(idx), generation(gen) {}
+
+    bool isNull() const { return index == INVALID_INDEX; }
+
+    bool operator==(const VehicleHandle &other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const VehicleHandle &other) const { return !(*this == other); }
+};
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef VEHICLESTORE_H
+#define VEHICLESTORE_H
+
+#include <vector>
+#include <cstdint>
+#include <SFML/System/Vector2.hpp>
+#include "Vehicle.h"
+#include "VehicleHandle.h"
+#include "RoutePool.h"
+using namespace std;
+
+// Structure-of-arrays storage for the simulation's vehicles.
+// Every attribute lives in its own contiguous column indexed by row, so the per-tick
+// movement pass only streams through the columns it actually reads and writes.
+// Rows are dense and move on removal; other subsystems hold VehicleHandles, which go
+// through a generational slot table (slot -> row) and stay valid until the vehicle is removed.
+// Paths are interned in a RoutePool; a row only keeps its route ID and how far along it is.
+class VehicleStore
+{
+    // Hot columns (touched by every movement pass)
+    vector<VehicleStatus> statuses;
+    vector<float> speeds;
+    vector<float> interpolations;
+    vector<sf::Vector2<float>> positions;
+    vector<sf::Vector2<float>> startPositions;
+    vector<sf::Vector2<float>> targetPositions;
+
+    // Cold columns (touched only when a vehicle reaches a node)
+    vector<int> ids;
+    vector<int> priorities;
+    vector<int> pathCursors; // index into the row's route of the node it last reached
+    vector<float> spawnTimes;
+    vector<float> expectedArrivals; // Predicted at spawn, -1 if none was made
+    vector<int> routeIDs; // -1 for a vehicle created without a path
+
+    RoutePool routes;
+
+    // Slot map
+    vector<uint32_t> rowSlots;        // row -> slot
+    vector<uint32_t> slotRows;        // slot -> row (meaningless while the slot is free)
+    vector<uint32_t> slotGenerations; // bumped every time the slot's vehicle is removed
+    vector<uint32_t> freeSlots;       // removed slots, reused before growing
+
+    VehicleHandle assignSlot(uint32_t row);
+
+public:
+    VehicleStore();
+
+    // Handle management (all O(1))
+    VehicleHandle add(const Vehicle &vehicle, float spawnTime = 0.0f); // Copies a freshly built vehicle into the columns
+    // Adds a vehicle at the start of 'path' heading for its second node, without building a Vehicle first
+    VehicleHandle add(int id, const vector<int> &path, float speed, int priority, const sf::Vector2<float> &startPosition, const sf::Vector2<float> &targetPosition, float spawnTime);
+    bool remove(VehicleHandle handle);         // Swap-and-pop the row, retire the handle; false if already stale
+    int rowOf(VehicleHandle handle) const;     // Current row, -1 if the handle is stale
+    bool isValid(VehicleHandle handle) const;
+    VehicleHandle handleAt(int row) const;
+
+    int size() const;
+    bool empty() const;
+    void reserve(int capacity);
+    void clear();
+
+    // Hot path: interpolate all moving vehicles, appending rows that reached their target node to 'reached'
+    void updatePositions(float deltaTime, vector<int> &reached);
+
+    // Per-row operations
+    void moveToNextNode(int row, const sf::Vector2<float> &nextNodePos);
+    void setStatus(int row, VehicleStatus newStatus);
+    void setTargetPosition(int row, const sf::Vector2<float> &target); // Also restarts the interpolation
+    // Swap the row's route for 'path', keeping its place along it; 'path' must match the old route up to there
+    bool replaceRoute(int row, const vector<int> &path);
+    void setExpectedArrival(int row, float time);
+
+    // Per-row getters
+    int getID(int row) const;
+    VehicleStatus getStatus(int row) const;
+    int getCurrentNode(int row) const;
+    int getNextNode(int row) const;
+    int getOriginNode(int row) const;
+    int getDestNode(int row) const;
+    int getRouteID(int row) const;
+    int getPathCursor(int row) const; // Index in the route of the current node
+    vector<int> getPath(int row) const; // Copy of the row's route
+    float getSpeed(int row) const;
+    sf::Vector2<float> getPosition(int row) const;
+    float getInterpolation(int row) const;
+    float getSpawnTime(int row) const;
+    float getExpectedArrival(int row) const; // -1 if none was predicted
+    int getPriority(int row) const;
+    bool isEmergency(int row) const;
+    bool hasArrivedDest(int row) const;
+
+    // Whole columns (for bulk passes such as rendering and analytics)
+    const vector<VehicleStatus> &getStatuses() const;
+    const vector<int> &getPriorities() const;
+    const vector<sf::Vector2<float>> &getPositions() const;
+    const RoutePool &getRoutes() const;
+};
+
+#endif
@@ -0,0 +1,145 @@
+#include "../include/AliasTable.h"
+#include <algorithm>
+
+static const double COIN_RANGE = 4294967296.0; // 2^32
+
+AliasTable::AliasTable() : total(0.0) {}
+
+double AliasTable::fill(const double *weights, int count, Entry *out)
+{
+    double sum = 0.0;
+    int heaviest = -1;
+    for (int i = 0; i < count; i++)
+    {
+        out[i].threshold = 0;
+        out[i].alias = i;
+        if (weights[i] > 0.0)
+        {
+            sum += weights[i];
+            if (heaviest == -1 || weights[i] > weights[heaviest])
+                heaviest = i;
+        }
+    }
+
+    if (!(sum > 0.0))
+        return 0.0;
+
+    // Vose: pair every under-full column with an over-full one that tops it up
+    vector<double> scaled(count);
+    vector<int> small, large;
+    for (int i = 0; i < count; i++)
+    {
+        scaled[i] = (weights[i] > 0.0) ? weights[i] * count / sum : 0.0;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        int under = small.back();
+        small.pop_back();
+        int over = large.back();
+
+        out[under].threshold = static_cast<uint32_t>(scaled[under] * COIN_RANGE);
+        out[under].alias = over;
+
+        scaled[over] -= 1.0 - scaled[under];
+        if (scaled[over] < 1.0)
+        {
+            large.pop_back();
+            small.push_back(over);
+        }
+    }
+
+    // Whatever is left is full up to rounding, except that a zero-weight leftover must never be kept
+    for (int i : large)
+        out[i].threshold = UINT32_MAX;
+    for (int i : small)
+    {
+        out[i].threshold = (weights[i] > 0.0) ? UINT32_MAX : 0;
+        out[i].alias = (weights[i] > 0.0) ? i : heaviest;
+    }
+    return sum;
+}
+
+void AliasTable::build(const double *weights, int count)
+{
+    entries.resize(count);
+    total = fill(weights, count, entries.data());
+}
+
+void AliasTable::clear()
+{
+    entries.clear();
+    total = 0.0;
+}
+
+const int BucketedAliasTable::BUCKET_SIZE;
+
+BucketedAliasTable::BucketedAliasTable() : topDirty(false) {}
+
+int BucketedAliasTable::bucketSize(int bucket) const
+{
+    return min(BUCKET_SIZE, static_cast<int>(weights.size()) - bucket * BUCKET_SIZE);
+}
+
+void BucketedAliasTable::assign(const vector<double> &itemWeights)
+{
+    weights = itemWeights;
+    entries.resize(weights.size());
+
+    int count = (static_cast<int>(weights.size()) + BUCKET_SIZE - 1) / BUCKET_SIZE;
+    bucketTotals.assign(count, 0.0);
+    isDirty.assign(count, 1);
+    dirtyBuckets.resize(count);
+    for (int b = 0; b < count; b++)
+        dirtyBuckets[b] = b;
+    topDirty = true;
+}
+
+void BucketedAliasTable::set(int item, double weight)
+{
+    weights[item] = weight;
+
+    int bucket = item / BUCKET_SIZE;
+    if (!isDirty[bucket])
+    {
+        isDirty[bucket] = 1;
+        dirtyBuckets.push_back(bucket);
+    }
+    topDirty = true;
+}
+
+void BucketedAliasTable::refresh()
+{
+    if (!topDirty)
+        return;
+
+    for (int bucket : dirtyBuckets)
+    {
+        int first = bucket * BUCKET_SIZE;
+        bucketTotals[bucket] = AliasTable::fill(weights.data() + first, bucketSize(bucket), entries.data() + first);
+        isDirty[bucket] = 0;
+    }
+    dirtyBuckets.clear();
+
+    top.build(bucketTotals.data(), static_cast<int>(bucketTotals.size()));
+    topDirty = false;
+}
+
+double BucketedAliasTable::getTotal()
+{
+    refresh();
+    return top.getTotal();
+}
+
+int BucketedAliasTable::sample(mt19937 &rng)
+{
+    refresh();
+    if (top.empty())
+        return -1;
+
+    // A single bucket needs no top-level draw
+    int bucket = (bucketTotals.size() == 1) ? 0 : top.sample(rng);
+    int first = bucket * BUCKET_SIZE;
+    return first + AliasTable::pick(entries.data() + first, bucketSize(bucket), rng());
+}
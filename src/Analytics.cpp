@@ -3,36 +3,50 @@
 #include <fstream>
 #include <algorithm>
 #include <iomanip>
+#include <cmath>
 
-Analytics::Analytics()
+Analytics::Analytics() : roadNetwork(nullptr), roadSegmentsUsed(0), totalTravelTime(0.0), totalETAError(0.0), totalETABias(0.0), predictedTrips(0)
 {
     cout << "Analytics system initialized" << endl;
 }
 
-string Analytics::getRoadKey(int from, int to) const
+void Analytics::setRoadNetwork(const Graph *graph)
 {
-    return to_string(from) + "-" + to_string(to);
+    roadNetwork = graph;
+    edgeUsage.assign(graph ? graph->getNumEdges() : 0, 0);
+    roadSegmentsUsed = 0;
 }
 
-void Analytics::recordVehicleSpawn(int vehicleID, float time, bool isEmergency)
+void Analytics::recordVehicleSpawn(bool isEmergency)
 {
-    vehicleSpawnTimes[vehicleID] = time;
     stats.totalVehiclesSpawned++;
 
     if (isEmergency)
         stats.totalEmergencyVehicles++;
 }
 
-void Analytics::recordVehicleArrival(int vehicleID, float time)
+void Analytics::recordTrip(const TripRecord &trip)
 {
-    vehicleArrivalTimes[vehicleID] = time;
+    trips.push_back(trip);
+    totalTravelTime += trip.travelTime();
     stats.totalArrivedVehicles++;
+
+    if (trip.hasPrediction())
+    {
+        double error = trip.arrivalTime - trip.expectedArrival;
+        totalETAError += fabs(error);
+        totalETABias += error;
+        predictedTrips++;
+    }
 }
 
-void Analytics::recordRoadUsage(int fromNode, int toNode)
+void Analytics::recordRoadUsage(int edge)
 {
-    string key = getRoadKey(fromNode, toNode);
-    roadUsage[key]++;
+    if (edge < 0 || edge >= static_cast<int>(edgeUsage.size()))
+        return;
+
+    if (edgeUsage[edge]++ == 0)
+        roadSegmentsUsed++;
 }
 
 void Analytics::recordSignalToggle()
@@ -90,14 +104,17 @@ vector<RoadCongestion> Analytics::getCongestionData() const
 {
     vector<RoadCongestion> congestion;
 
-    for (const auto &pair : roadUsage)
-    {
-        // Parse "from-to" key
-        size_t dashPos = pair.first.find('-');
-        int from = stoi(pair.first.substr(0, dashPos));
-        int to = stoi(pair.first.substr(dashPos + 1));
+    if (!roadNetwork)
+        return congestion;
 
-        congestion.push_back(RoadCongestion(from, to, pair.second));
+    // Walk the CSR edges in order; the edge's source is the node whose range contains it
+    for (int u = 0; u < roadNetwork->getNumNodes(); u++)
+    {
+        for (int e = roadNetwork->edgeBegin(u); e < roadNetwork->edgeEnd(u); e++)
+        {
+            if (edgeUsage[e] > 0)
+                congestion.push_back(RoadCongestion(roadNetwork->idOf(u), roadNetwork->idOf(roadNetwork->edgeTarget(e)), edgeUsage[e]));
+        }
     }
 
     return congestion;
@@ -130,34 +147,25 @@ RoadCongestion Analytics::getBusiestRoad()
     return sortedRoads[0]; // First element is busiest after sorting
 }
 
-void Analytics::updateStats(const vector<Vehicle> &vehicles, const vector<TrafficSignal> &signals, float currentTime)
+void Analytics::updateStats(const VehicleStore &vehicles, const vector<TrafficSignal> &signals, float currentTime)
 {
     stats.simulationDuration = currentTime;
 
-    // Count active vehicles
-    int active = 0, arrived = 0, queued = 0, emergency = 0;;
-    for (const auto &vehicle : vehicles)
+    // Count live vehicles (reads only the status column; arrived vehicles have already been retired)
+    const vector<VehicleStatus> &statuses = vehicles.getStatuses();
+
+    int active = 0, queued = 0;
+    for (int row = 0; row < vehicles.size(); row++)
     {
-        if (vehicle.hasArrivedDest())
-            arrived++;
-        else if (vehicle.getStatus() == VehicleStatus::WAITING)
+        if (statuses[row] == VehicleStatus::WAITING)
             queued++;
-        else if (vehicle.isEmergency())
-        {
-            emergency++;
+        else if (statuses[row] != VehicleStatus::ARRIVED)
             active++;
-        }
-        else
-            active++;
-        
-        if (vehicle.isEmergency())
-            emergency++;
     }
 
     stats.currentActiveVehicles = active;
-    stats.totalArrivedVehicles = arrived;
+    stats.totalArrivedVehicles = trips.size();
     stats.totalQueuedVehicles = queued;
-    stats.totalEmergencyVehicles = emergency;
 
     // Calculate average queue size
     int totalQueueSize = 0;
@@ -168,27 +176,14 @@ void Analytics::updateStats(const vector<Vehicle> &vehicles, const vector<Traffi
     if (!signals.empty())
         stats.averageQueueSize = static_cast<double>(totalQueueSize) / signals.size();
 
-    // Calculate average travel time
-    double totalTravelTime = 0.0;
-    int completedTrips = 0;
-
-    for (const auto &pair : vehicleArrivalTimes)
-    {
-        int vehicleID = pair.first;
-        float arrivalTime = pair.second;
-
-        if (vehicleSpawnTimes.count(vehicleID) > 0)
-        {
-            float spawnTime = vehicleSpawnTimes[vehicleID];
-            totalTravelTime += (arrivalTime - spawnTime);
-            completedTrips++;
-        }
-    }
-
-    stats.averageTravelTime = completedTrips > 0 ? totalTravelTime / completedTrips : 0.0;
+    // Average travel time from the running total kept by recordTrip()
+    stats.averageTravelTime = !trips.empty() ? totalTravelTime / trips.size() : 0.0;
+    stats.predictedTrips = predictedTrips;
+    stats.averageETAError = predictedTrips > 0 ? totalETAError / predictedTrips : 0.0;
+    stats.averageETABias = predictedTrips > 0 ? totalETABias / predictedTrips : 0.0;
 
     // Find busiest road
-    if (!roadUsage.empty())
+    if (roadSegmentsUsed > 0)
     {
         RoadCongestion busiest = getBusiestRoad();
         if (busiest.fromNode != -1)
@@ -200,6 +195,8 @@ void Analytics::updateStats(const vector<Vehicle> &vehicles, const vector<Traffi
 }
 
 SimulationStats Analytics::getStats() const { return stats; }
+const vector<TripRecord> &Analytics::getTrips() const { return trips; }
+int Analytics::getCompletedTrips() const { return trips.size(); }
 double Analytics::getAverageTravelTime() const { return stats.averageTravelTime; }
 
 bool Analytics::saveToFile(const string &filename)
@@ -226,8 +223,10 @@ bool Analytics::saveToFile(const string &filename)
     file << "Successfully Arrived:      " << stats.totalArrivedVehicles << endl;
     file << "Emergency Vehicles:        " << stats.totalEmergencyVehicles << endl;
     file << "Currently Queued:          " << stats.totalQueuedVehicles << endl;
-    file << "Completed Trips:           " << vehicleArrivalTimes.size() << endl;
+    file << "Completed Trips:           " << trips.size() << endl;
     file << "Average Travel Time:       " << fixed << setprecision(2) << stats.averageTravelTime << " seconds" << endl;
+    if (stats.predictedTrips > 0)
+        file << "Average ETA Error:         " << fixed << setprecision(2) << stats.averageETAError << " seconds (bias " << stats.averageETABias << ", " << stats.predictedTrips << " trips)" << endl;
     file << endl;
 
     file << "--- TRAFFIC FLOW ---" << endl;
@@ -241,7 +240,7 @@ bool Analytics::saveToFile(const string &filename)
         file << "Busiest Road:              No traffic data collected" << endl;
     }
     
-    file << "Total Road Segments Used:  " << roadUsage.size() << endl;
+    file << "Total Road Segments Used:  " << roadSegmentsUsed << endl;
     file << endl;
 
     file << "--- USER INTERACTIONS ---" << endl;
@@ -279,6 +278,8 @@ void Analytics::printSummary() const
     cout << "Vehicles Arrived: " << stats.totalArrivedVehicles << endl;
     cout << "Emergency Vehicles: " << stats.totalEmergencyVehicles << endl;
     cout << "Avg Travel Time: " << fixed << setprecision(2) << stats.averageTravelTime << "s" << endl;
+    if (stats.predictedTrips > 0)
+        cout << "Avg ETA Error: " << fixed << setprecision(2) << stats.averageETAError << "s (bias " << stats.averageETABias << "s)" << endl;
     cout << "Busiest Road: " << stats.busiestRoad << " (" << stats.busiestRoadCount << " vehicles)" << endl;
     cout << "Signal Toggles: " << stats.totalSignalToggles << endl;
     cout << "Undo Operations: " << stats.totalUndoOperations << endl;
@@ -288,9 +289,13 @@ void Analytics::printSummary() const
 
 void Analytics::clear()
 {
-    roadUsage.clear();
-    vehicleSpawnTimes.clear();
-    vehicleArrivalTimes.clear();
+    edgeUsage.assign(edgeUsage.size(), 0);
+    roadSegmentsUsed = 0;
+    trips.clear();
+    totalTravelTime = 0.0;
+    totalETAError = 0.0;
+    totalETABias = 0.0;
+    predictedTrips = 0;
     stats = SimulationStats();
 
     cout << "Analytics data cleared" << endl;
@@ -0,0 +1,96 @@
+#include "../include/CongestionModel.h"
+#include <algorithm>
+#include <cmath>
+
+static const double SMOOTHING = 0.3;        // Weight of the newest window in the moving average
+static const double CHANGE_THRESHOLD = 0.1; // Relative weight change worth publishing
+static const double SETTLED = 1.01;         // Factor below which an idle road counts as free again
+
+CongestionModel::CongestionModel() : samples(0), freeFlowTime(1.0) {}
+
+void CongestionModel::reset(const Graph &map, double freeFlowSeconds)
+{
+    int numEdges = map.getNumEdges();
+    freeFlowTime = freeFlowSeconds;
+    baseWeights.resize(numEdges);
+    for (int e = 0; e < numEdges; e++)
+        baseWeights[e] = map.edgeWeight(e);
+
+    smoothedTimes.assign(numEdges, freeFlowTime);
+    occupancy.assign(numEdges, 0);
+    entries.assign(numEdges, 0);
+    active.assign(numEdges, 0);
+    activeEdges.clear();
+    samples = 0;
+}
+
+void CongestionModel::clear()
+{
+    baseWeights.clear();
+    smoothedTimes.clear();
+    occupancy.clear();
+    entries.clear();
+    active.clear();
+    activeEdges.clear();
+    samples = 0;
+}
+
+void CongestionModel::activate(int edge)
+{
+    if (!active[edge])
+    {
+        active[edge] = 1;
+        activeEdges.push_back(edge);
+    }
+}
+
+void CongestionModel::update(Graph &map, double windowSeconds, vector<pair<int, double>> &slower)
+{
+    int kept = 0;
+    for (int edge : activeEdges)
+    {
+        // Little's law: time per vehicle = average vehicles on the road / arrival rate. A road that
+        // nobody entered still counts one arrival, so a queue that never moves reads as slow.
+        double observed = freeFlowTime;
+        if (occupancy[edge] > 0 && samples > 0)
+        {
+            double averageOnRoad = static_cast<double>(occupancy[edge]) / samples;
+            observed = max(freeFlowTime, averageOnRoad * windowSeconds / max(entries[edge], 1));
+        }
+        bool idle = occupancy[edge] == 0 && entries[edge] == 0;
+        occupancy[edge] = 0;
+        entries[edge] = 0;
+
+        smoothedTimes[edge] += SMOOTHING * (observed - smoothedTimes[edge]);
+        double target = baseWeights[edge] * getFactor(edge);
+        if (idle && getFactor(edge) < SETTLED)
+        {
+            smoothedTimes[edge] = freeFlowTime;
+            target = baseWeights[edge];
+        }
+
+        double current = map.edgeWeight(edge);
+        if (fabs(target - current) > CHANGE_THRESHOLD * current || (target == baseWeights[edge] && current != target))
+        {
+            map.setEdgeWeight(edge, target);
+            if (target > current)
+                slower.push_back(make_pair(edge, target - current));
+        }
+
+        // Back at free flow with no traffic: nothing left to track
+        if (idle && target == baseWeights[edge])
+            active[edge] = 0;
+        else
+            activeEdges[kept++] = edge;
+    }
+    activeEdges.resize(kept);
+    samples = 0;
+}
+
+int CongestionModel::getCongestedCount() const
+{
+    int count = 0;
+    for (int edge : activeEdges)
+        count += getFactor(edge) >= 1.5;
+    return count;
+}
@@ -0,0 +1,622 @@
+#include "../include/ContractionHierarchy.h"
+#include "../include/ParallelFor.h"
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+
+static const int SIMULATE_SETTLE_LIMIT = 20;  // Witness search budget when estimating a node's priority
+static const int CONTRACT_SETTLE_LIMIT = 200; // Witness search budget when actually contracting it
+
+static const char FILE_MAGIC[4] = {'T', 'S', 'C', 'H'};
+static const uint32_t FILE_VERSION = 2; // 2: map fingerprint after the header
+
+struct Shortcut
+{
+    int from;
+    int to;
+    double weight;
+    int via;
+};
+
+// The graph while it is being contracted: arcs to contracted nodes are removed, shortcuts added
+struct WorkingGraph
+{
+    vector<vector<CHArc>> out;
+    vector<vector<CHArc>> in;
+    vector<char> contracted;
+    vector<char> selected;  // Being contracted this round; witness paths may not use these
+    vector<int> deletedNeighbours;
+};
+
+// Keep the cheaper of two parallel arcs
+static void addArc(vector<CHArc> &arcs, int node, double weight, int via)
+{
+    for (CHArc &arc : arcs)
+    {
+        if (arc.node == node)
+        {
+            if (weight < arc.weight)
+            {
+                arc.weight = weight;
+                arc.via = via;
+            }
+            return;
+        }
+    }
+    arcs.push_back({weight, node, via});
+}
+
+static void removeArc(vector<CHArc> &arcs, int node)
+{
+    for (int i = 0; i < static_cast<int>(arcs.size()); i++)
+    {
+        if (arcs[i].node == node)
+        {
+            arcs[i] = arcs.back();
+            arcs.pop_back();
+            return;
+        }
+    }
+}
+
+// Shortcuts needed to contract u: x -> u -> y for every in-neighbour x and out-neighbour y, unless a
+// witness path x ~> y that avoids u (and this round's other nodes) is no longer. A search that runs out
+// of budget counts as "no witness", which only costs an unnecessary shortcut.
+static void findShortcuts(const WorkingGraph &g, int u, int settleLimit, SearchWorkspace &ws, vector<Shortcut> &shortcuts)
+{
+    const vector<CHArc> &ins = g.in[u];
+    const vector<CHArc> &outs = g.out[u];
+    if (ins.empty() || outs.empty())
+        return;
+
+    double maxOut = 0.0;
+    for (const CHArc &arc : outs)
+        maxOut = max(maxOut, arc.weight);
+
+    IndexedDaryHeap<double> &pq = ws.queue();
+    for (const CHArc &inArc : ins)
+    {
+        int x = inArc.node;
+        double limit = inArc.weight + maxOut;
+
+        ws.begin(g.out.size());
+        ws.setDistance(x, 0, -1);
+        pq.push(x, 0);
+
+        // Stop once every out-neighbour (other than x itself) has its final distance
+        int targetsLeft = 0;
+        for (const CHArc &outArc : outs)
+            targetsLeft += (outArc.node != x);
+
+        int settled = 0;
+        while (!pq.empty() && targetsLeft > 0)
+        {
+            int v = pq.top();
+            double d = pq.topKey();
+            pq.pop();
+
+            if (d > limit || ++settled > settleLimit)
+                break;
+
+            for (const CHArc &outArc : outs)
+            {
+                if (outArc.node == v && v != x)
+                    targetsLeft--;
+            }
+
+            for (const CHArc &arc : g.out[v])
+            {
+                int w = arc.node;
+                if (w == u || g.selected[w])
+                    continue;
+
+                double candidate = d + arc.weight;
+                if (candidate < ws.distance(w))
+                {
+                    ws.setDistance(w, candidate, v);
+                    if (pq.contains(w))
+                        pq.decreaseKey(w, candidate);
+                    else
+                        pq.push(w, candidate);
+                }
+            }
+        }
+
+        // A tentative distance is still the length of a real path, so it is a valid witness
+        for (const CHArc &outArc : outs)
+        {
+            int y = outArc.node;
+            double through = inArc.weight + outArc.weight;
+            if (y != x && ws.distance(y) > through)
+                shortcuts.push_back({x, y, through, u});
+        }
+    }
+}
+
+// Edge difference plus contracted neighbours: prefers nodes that add few shortcuts, spread evenly
+static int computePriority(const WorkingGraph &g, int u, SearchWorkspace &ws, vector<Shortcut> &scratch)
+{
+    scratch.clear();
+    findShortcuts(g, u, SIMULATE_SETTLE_LIMIT, ws, scratch);
+    return 2 * static_cast<int>(scratch.size()) - static_cast<int>(g.in[u].size() + g.out[u].size()) + g.deletedNeighbours[u];
+}
+
+// Tie-break for equal priorities that doesn't favour runs of consecutive indices
+static uint32_t scramble(int node)
+{
+    return static_cast<uint32_t>(node) * 2654435761u;
+}
+
+ContractionHierarchy::ContractionHierarchy() : graph(nullptr), numNodes(0), numEdges(0), fingerprint(0), shortcutCount(0) {}
+
+bool ContractionHierarchy::build(const Graph &map, int threads)
+{
+    if (!map.isFrozen())
+    {
+        cout << "Error: Graph must be frozen before building a contraction hierarchy" << endl;
+        return false;
+    }
+
+    if (threads <= 0)
+        threads = max(1u, thread::hardware_concurrency());
+
+    graph = &map;
+    numNodes = map.getNumNodes();
+    numEdges = map.getNumEdges();
+    fingerprint = map.computeFingerprint();
+    shortcutCount = 0;
+
+    nodeIDs.resize(numNodes);
+    for (int u = 0; u < numNodes; u++)
+        nodeIDs[u] = map.idOf(u);
+
+    WorkingGraph g;
+    g.out.resize(numNodes);
+    g.in.resize(numNodes);
+    g.contracted.assign(numNodes, 0);
+    g.selected.assign(numNodes, 0);
+    g.deletedNeighbours.assign(numNodes, 0);
+
+    for (int u = 0; u < numNodes; u++)
+    {
+        for (int e = map.edgeBegin(u); e < map.edgeEnd(u); e++)
+        {
+            int v = map.edgeTarget(e);
+            if (v == u)
+                continue; // A loop never lies on a shortest path
+            addArc(g.out[u], v, map.edgeWeight(e), -1);
+            addArc(g.in[v], u, map.edgeWeight(e), -1);
+        }
+    }
+
+    // One search workspace and scratch list per thread
+    vector<SearchWorkspace> workspaces(threads);
+    vector<vector<Shortcut>> scratch(threads);
+
+    vector<int> priority(numNodes);
+    vector<int> remaining(numNodes);
+    for (int u = 0; u < numNodes; u++)
+        remaining[u] = u;
+
+    parallelFor(numNodes, threads, [&](int begin, int end, int t)
+    {
+        for (int i = begin; i < end; i++)
+            priority[i] = computePriority(g, i, workspaces[t], scratch[t]);
+    });
+
+    vector<vector<CHArc>> up(numNodes), down(numNodes);
+    rank.assign(numNodes, -1);
+    int nextRank = 0;
+
+    vector<int> selectedNodes, dirtyNodes;
+    vector<vector<Shortcut>> shortcutsOf;
+    vector<char> dirty(numNodes, 0);
+
+    while (!remaining.empty())
+    {
+        // Pick every node that beats all of its neighbours; these are pairwise non-adjacent
+        selectedNodes.clear();
+        for (int u : remaining)
+        {
+            bool isMinimum = true;
+            for (int side = 0; side < 2 && isMinimum; side++)
+            {
+                for (const CHArc &arc : (side == 0 ? g.out[u] : g.in[u]))
+                {
+                    int v = arc.node;
+                    if (priority[v] < priority[u] || (priority[v] == priority[u] && (scramble(v) < scramble(u) || (scramble(v) == scramble(u) && v < u))))
+                    {
+                        isMinimum = false;
+                        break;
+                    }
+                }
+            }
+
+            if (isMinimum)
+            {
+                selectedNodes.push_back(u);
+                g.selected[u] = 1;
+            }
+        }
+
+        // Shortcut searches only read the graph, so the whole set is processed in parallel
+        shortcutsOf.assign(selectedNodes.size(), vector<Shortcut>());
+        parallelFor(selectedNodes.size(), threads, [&](int begin, int end, int t)
+        {
+            for (int i = begin; i < end; i++)
+                findShortcuts(g, selectedNodes[i], CONTRACT_SETTLE_LIMIT, workspaces[t], shortcutsOf[i]);
+        });
+
+        // Remove the set: its remaining arcs all lead to higher-ranked nodes and become the upward arcs
+        for (int u : selectedNodes)
+        {
+            rank[u] = nextRank++;
+            up[u] = g.out[u];
+            down[u] = g.in[u];
+            g.contracted[u] = 1;
+            g.selected[u] = 0;
+
+            for (const CHArc &arc : g.out[u])
+            {
+                removeArc(g.in[arc.node], u);
+                g.deletedNeighbours[arc.node]++;
+                dirty[arc.node] = 1;
+            }
+            for (const CHArc &arc : g.in[u])
+            {
+                removeArc(g.out[arc.node], u);
+                g.deletedNeighbours[arc.node]++;
+                dirty[arc.node] = 1;
+            }
+
+            g.out[u].clear();
+            g.out[u].shrink_to_fit();
+            g.in[u].clear();
+            g.in[u].shrink_to_fit();
+        }
+
+        for (const vector<Shortcut> &list : shortcutsOf)
+        {
+            for (const Shortcut &shortcut : list)
+            {
+                addArc(g.out[shortcut.from], shortcut.to, shortcut.weight, shortcut.via);
+                addArc(g.in[shortcut.to], shortcut.from, shortcut.weight, shortcut.via);
+                dirty[shortcut.from] = 1;
+                dirty[shortcut.to] = 1;
+            }
+        }
+
+        remaining.erase(remove_if(remaining.begin(), remaining.end(), [&](int u) { return g.contracted[u] != 0; }), remaining.end());
+
+        // Only the neighbourhood of this round's nodes changed
+        dirtyNodes.clear();
+        for (int u : remaining)
+        {
+            if (dirty[u])
+            {
+                dirtyNodes.push_back(u);
+                dirty[u] = 0;
+            }
+        }
+
+        parallelFor(dirtyNodes.size(), threads, [&](int begin, int end, int t)
+        {
+            for (int i = begin; i < end; i++)
+                priority[dirtyNodes[i]] = computePriority(g, dirtyNodes[i], workspaces[t], scratch[t]);
+        });
+    }
+
+    // Flatten the upward arcs into CSR form
+    upOffsets.assign(numNodes + 1, 0);
+    downOffsets.assign(numNodes + 1, 0);
+    upArcs.clear();
+    downArcs.clear();
+
+    for (int u = 0; u < numNodes; u++)
+    {
+        upArcs.insert(upArcs.end(), up[u].begin(), up[u].end());
+        downArcs.insert(downArcs.end(), down[u].begin(), down[u].end());
+        upOffsets[u + 1] = upArcs.size();
+        downOffsets[u + 1] = downArcs.size();
+    }
+
+    for (const CHArc &arc : upArcs)
+        shortcutCount += (arc.via != -1);
+    for (const CHArc &arc : downArcs)
+        shortcutCount += (arc.via != -1);
+
+    cout << "Contraction hierarchy built: " << numNodes << " nodes, " << shortcutCount << " shortcuts (" << threads << " threads)" << endl;
+    return true;
+}
+
+bool ContractionHierarchy::isReady() const { return graph != nullptr; }
+
+vector<int> ContractionHierarchy::findRoute(int start, int end)
+{
+    return findRoute(start, end, forwardSearch, backwardSearch);
+}
+
+vector<int> ContractionHierarchy::findRoute(int start, int end, SearchWorkspace &forward, SearchWorkspace &backward) const
+{
+    if (!isReady())
+    {
+        cout << "Error: Contraction hierarchy has not been built" << endl;
+        return {};
+    }
+
+    int startIndex = graph->indexOf(start);
+    int endIndex = graph->indexOf(end);
+
+    if (startIndex == -1 || endIndex == -1)
+    {
+        cout << "Error: Start or end node doesn't exist" << endl;
+        return {};
+    }
+
+    forward.begin(numNodes);
+    backward.begin(numNodes);
+    forward.setDistance(startIndex, 0, -1);
+    backward.setDistance(endIndex, 0, -1);
+
+    IndexedDaryHeap<double> &forwardQueue = forward.queue();
+    IndexedDaryHeap<double> &backwardQueue = backward.queue();
+    forwardQueue.push(startIndex, 0);
+    backwardQueue.push(endIndex, 0);
+
+    // Both searches only climb; the shortest path is the best meeting point of the two
+    double best = numeric_limits<double>::infinity();
+    int meeting = -1;
+
+    while (true)
+    {
+        bool forwardActive = !forwardQueue.empty() && forwardQueue.topKey() < best;
+        bool backwardActive = !backwardQueue.empty() && backwardQueue.topKey() < best;
+        if (!forwardActive && !backwardActive)
+            break;
+
+        // Advance whichever side has the smaller key
+        bool useForward = forwardActive && (!backwardActive || forwardQueue.topKey() <= backwardQueue.topKey());
+        SearchWorkspace &ws = useForward ? forward : backward;
+        const SearchWorkspace &other = useForward ? backward : forward;
+        IndexedDaryHeap<double> &pq = ws.queue();
+        const vector<int> &offsets = useForward ? upOffsets : downOffsets;
+        const vector<CHArc> &arcs = useForward ? upArcs : downArcs;
+
+        int node = pq.top();
+        double d = pq.topKey();
+        pq.pop();
+        ws.countSettled();
+
+        double total = d + other.distance(node);
+        if (total < best)
+        {
+            best = total;
+            meeting = node;
+        }
+
+        // Stall-on-demand: if a higher node already reached by this search has an arc into this one
+        // that beats d, this node can't be on a shortest path, so don't expand it
+        const vector<int> &reverseOffsets = useForward ? downOffsets : upOffsets;
+        const vector<CHArc> &reverseArcs = useForward ? downArcs : upArcs;
+        bool stalled = false;
+        for (int e = reverseOffsets[node]; e < reverseOffsets[node + 1] && !stalled; e++)
+            stalled = ws.distance(reverseArcs[e].node) + reverseArcs[e].weight < d;
+        if (stalled)
+            continue;
+
+        for (int e = offsets[node]; e < offsets[node + 1]; e++)
+        {
+            int next = arcs[e].node;
+            double candidate = d + arcs[e].weight;
+            if (candidate < ws.distance(next))
+            {
+                ws.setDistance(next, candidate, node);
+                if (pq.contains(next))
+                    pq.decreaseKey(next, candidate);
+                else
+                    pq.push(next, candidate);
+            }
+        }
+    }
+
+    vector<int> path;
+    if (meeting == -1)
+    {
+        cout << "No path found from " << start << " to " << end << endl;
+        return path;
+    }
+
+    // Hierarchy-level path: start ... meeting (forward parents) then meeting ... end (backward parents)
+    vector<int> levels;
+    for (int node = meeting; node != -1; node = forward.parentOf(node))
+        levels.push_back(node);
+    reverse(levels.begin(), levels.end());
+    for (int node = backward.parentOf(meeting); node != -1; node = backward.parentOf(node))
+        levels.push_back(node);
+
+    // Expand shortcuts back into the original roads
+    vector<int> dense;
+    dense.push_back(levels[0]);
+    for (int i = 0; i + 1 < static_cast<int>(levels.size()); i++)
+        unpackArc(levels[i], levels[i + 1], dense);
+
+    path.reserve(dense.size());
+    for (int node : dense)
+        path.push_back(nodeIDs[node]);
+    return path;
+}
+
+const CHArc *ContractionHierarchy::findArc(int from, int to) const
+{
+    // An arc is stored at its lower-ranked end
+    if (rank[to] > rank[from])
+    {
+        for (int e = upOffsets[from]; e < upOffsets[from + 1]; e++)
+        {
+            if (upArcs[e].node == to)
+                return &upArcs[e];
+        }
+    }
+    else
+    {
+        for (int e = downOffsets[to]; e < downOffsets[to + 1]; e++)
+        {
+            if (downArcs[e].node == from)
+                return &downArcs[e];
+        }
+    }
+    return nullptr;
+}
+
+void ContractionHierarchy::unpackArc(int from, int to, vector<int> &path) const
+{
+    const CHArc *arc = findArc(from, to);
+    if (arc == nullptr || arc->via == -1)
+    {
+        path.push_back(to);
+        return;
+    }
+
+    unpackArc(from, arc->via, path);
+    unpackArc(arc->via, to, path);
+}
+
+bool ContractionHierarchy::saveToFile(const string &fileName) const
+{
+    if (!isReady())
+    {
+        cout << "Error: Contraction hierarchy has not been built" << endl;
+        return false;
+    }
+
+    ofstream file(fileName, ios::binary);
+    if (!file.is_open())
+    {
+        cout << "Error in opening file " << fileName << endl;
+        return false;
+    }
+
+    int32_t header[4] = {numNodes, numEdges, static_cast<int32_t>(upArcs.size()), static_cast<int32_t>(downArcs.size())};
+    file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    file.write(reinterpret_cast<const char *>(&FILE_VERSION), sizeof(FILE_VERSION));
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(&fingerprint), sizeof(fingerprint));
+    file.write(reinterpret_cast<const char *>(nodeIDs.data()), numNodes * sizeof(int));
+    file.write(reinterpret_cast<const char *>(rank.data()), numNodes * sizeof(int));
+    file.write(reinterpret_cast<const char *>(upOffsets.data()), (numNodes + 1) * sizeof(int));
+    file.write(reinterpret_cast<const char *>(downOffsets.data()), (numNodes + 1) * sizeof(int));
+    file.write(reinterpret_cast<const char *>(upArcs.data()), upArcs.size() * sizeof(CHArc));
+    file.write(reinterpret_cast<const char *>(downArcs.data()), downArcs.size() * sizeof(CHArc));
+
+    if (!file)
+    {
+        cout << "Error writing contraction hierarchy to " << fileName << endl;
+        return false;
+    }
+
+    cout << "Contraction hierarchy saved to: " << fileName << endl;
+    return true;
+}
+
+bool ContractionHierarchy::loadFromFile(const string &fileName, const Graph &map)
+{
+    ifstream file(fileName, ios::binary);
+    if (!file.is_open())
+    {
+        cout << "Error in opening file " << fileName << endl;
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version;
+    int32_t header[4];
+    uint64_t storedFingerprint = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char *>(&version), sizeof(version));
+    file.read(reinterpret_cast<char *>(header), sizeof(header));
+    if (file && version == FILE_VERSION)
+        file.read(reinterpret_cast<char *>(&storedFingerprint), sizeof(storedFingerprint));
+
+    if (!file || !equal(magic, magic + 4, FILE_MAGIC) || version != FILE_VERSION)
+    {
+        cout << "Error: " << fileName << " is not a contraction hierarchy file" << endl;
+        return false;
+    }
+
+    // Same shape isn't enough: a changed road weight makes the shortcuts wrong
+    if (header[0] != map.getNumNodes() || header[1] != map.getNumEdges() || header[2] < 0 || header[3] < 0 || storedFingerprint != map.computeFingerprint())
+    {
+        cout << "Error: " << fileName << " was built for a different map" << endl;
+        return false;
+    }
+
+    int nodes = header[0];
+    vector<int> ids(nodes), ranks(nodes), up(nodes + 1), down(nodes + 1);
+    vector<CHArc> upList(header[2]), downList(header[3]);
+
+    file.read(reinterpret_cast<char *>(ids.data()), nodes * sizeof(int));
+    file.read(reinterpret_cast<char *>(ranks.data()), nodes * sizeof(int));
+    file.read(reinterpret_cast<char *>(up.data()), (nodes + 1) * sizeof(int));
+    file.read(reinterpret_cast<char *>(down.data()), (nodes + 1) * sizeof(int));
+    file.read(reinterpret_cast<char *>(upList.data()), upList.size() * sizeof(CHArc));
+    file.read(reinterpret_cast<char *>(downList.data()), downList.size() * sizeof(CHArc));
+
+    if (!file || up[0] != 0 || down[0] != 0 || up[nodes] != header[2] || down[nodes] != header[3])
+    {
+        cout << "Error: " << fileName << " is truncated or corrupt" << endl;
+        return false;
+    }
+
+    for (int u = 0; u < nodes; u++)
+    {
+        if (ids[u] != map.idOf(u))
+        {
+            cout << "Error: " << fileName << " was built for a different map" << endl;
+            return false;
+        }
+
+        if (up[u] > up[u + 1] || down[u] > down[u + 1] || ranks[u] < 0 || ranks[u] >= nodes)
+        {
+            cout << "Error: " << fileName << " is truncated or corrupt" << endl;
+            return false;
+        }
+    }
+
+    // Arc targets are used as array indices by every query, so check them once here
+    for (const vector<CHArc> *list : {&upList, &downList})
+    {
+        for (const CHArc &arc : *list)
+        {
+            if (arc.node < 0 || arc.node >= nodes || arc.via < -1 || arc.via >= nodes)
+            {
+                cout << "Error: " << fileName << " is truncated or corrupt" << endl;
+                return false;
+            }
+        }
+    }
+
+    graph = &map;
+    numNodes = nodes;
+    numEdges = header[1];
+    fingerprint = storedFingerprint;
+    nodeIDs.swap(ids);
+    rank.swap(ranks);
+    upOffsets.swap(up);
+    downOffsets.swap(down);
+    upArcs.swap(upList);
+    downArcs.swap(downList);
+
+    shortcutCount = 0;
+    for (const CHArc &arc : upArcs)
+        shortcutCount += (arc.via != -1);
+    for (const CHArc &arc : downArcs)
+        shortcutCount += (arc.via != -1);
+
+    cout << "Contraction hierarchy loaded from " << fileName << " (" << shortcutCount << " shortcuts)" << endl;
+    return true;
+}
+
+int ContractionHierarchy::getNumNodes() const { return numNodes; }
+int ContractionHierarchy::getShortcutCount() const { return shortcutCount; }
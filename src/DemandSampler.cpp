@@ -0,0 +1,135 @@
+#include "../include/DemandSampler.h"
+#include <algorithm>
+
+DemandSampler::DemandSampler() : components(nullptr) {}
+
+void DemandSampler::clear()
+{
+    components = nullptr;
+    positionOf.clear();
+    originWeights.clear();
+    destinationWeights.clear();
+    excluded.clear();
+    positiveDestinations.clear();
+    origins.assign(vector<double>());
+    destinations.clear();
+}
+
+void DemandSampler::build(const ReachabilityIndex &reachability)
+{
+    components = &reachability;
+    int numComponents = reachability.getNumComponents();
+
+    int numNodes = 0;
+    for (int c = 0; c < numComponents; c++)
+        numNodes += reachability.getComponentSize(c);
+
+    positionOf.assign(numNodes, 0);
+    originWeights.assign(numNodes, 1.0);
+    destinationWeights.assign(numNodes, 1.0);
+    excluded.assign(numNodes, 0);
+    positiveDestinations.assign(numComponents, 0);
+    destinations.assign(numComponents, BucketedAliasTable());
+
+    for (int c = 0; c < numComponents; c++)
+    {
+        int size = reachability.getComponentSize(c);
+        for (int k = 0; k < size; k++)
+            positionOf[reachability.memberAt(c, k)] = k;
+
+        positiveDestinations[c] = size;
+        if (size >= 2) // A lone node has nowhere to go, so it never needs a table
+            destinations[c].assign(vector<double>(size, 1.0));
+    }
+
+    vector<double> effective(numNodes);
+    for (int i = 0; i < numNodes; i++)
+        effective[i] = effectiveOriginWeight(i);
+    origins.assign(effective);
+}
+
+double DemandSampler::effectiveOriginWeight(int index) const
+{
+    if (excluded[index] || !(originWeights[index] > 0.0))
+        return 0.0;
+
+    // Needs a destination other than itself
+    int others = positiveDestinations[components->componentOfNode(index)] - (destinationWeights[index] > 0.0 ? 1 : 0);
+    return (others > 0) ? originWeights[index] : 0.0;
+}
+
+void DemandSampler::refreshOrigins(int component)
+{
+    int size = components->getComponentSize(component);
+    for (int k = 0; k < size; k++)
+    {
+        int index = components->memberAt(component, k);
+        origins.set(index, effectiveOriginWeight(index));
+    }
+}
+
+void DemandSampler::setOriginWeight(int index, double weight)
+{
+    originWeights[index] = max(weight, 0.0);
+    origins.set(index, effectiveOriginWeight(index));
+}
+
+void DemandSampler::setDestinationWeight(int index, double weight)
+{
+    weight = max(weight, 0.0);
+    int component = components->componentOfNode(index);
+    bool wasPositive = destinationWeights[index] > 0.0;
+    destinationWeights[index] = weight;
+
+    if (components->getComponentSize(component) >= 2)
+        destinations[component].set(positionOf[index], weight);
+
+    // Origins only care whether a component has zero, one or more destinations left
+    int before = positiveDestinations[component];
+    positiveDestinations[component] += (weight > 0.0) - wasPositive;
+    if (positiveDestinations[component] != before && min(before, positiveDestinations[component]) < 2)
+        refreshOrigins(component);
+}
+
+void DemandSampler::setExcluded(int index, bool isExcluded)
+{
+    excluded[index] = isExcluded;
+    origins.set(index, effectiveOriginWeight(index));
+}
+
+int DemandSampler::sampleOrigin(mt19937 &rng)
+{
+    return origins.sample(rng);
+}
+
+int DemandSampler::sampleDestination(int originIndex, mt19937 &rng)
+{
+    // With two or more destinations there is always one besides the origin
+    int component = components->componentOfNode(originIndex);
+    int size = components->getComponentSize(component);
+    if (size < 2 || (positiveDestinations[component] < 2 && positiveDestinations[component] - (destinationWeights[originIndex] > 0.0 ? 1 : 0) <= 0))
+        return -1;
+
+    // Redraw the origin itself; if it holds most of the weight, fall back to a walk that skips it
+    BucketedAliasTable &table = destinations[component];
+    for (int attempt = 0; attempt < 32; attempt++)
+    {
+        int k = table.sample(rng);
+        if (components->memberAt(component, k) != originIndex)
+            return components->memberAt(component, k);
+    }
+
+    double remaining = (table.getTotal() - destinationWeights[originIndex]) * (static_cast<double>(rng()) / 4294967296.0);
+    int last = -1;
+    for (int k = 0; k < size; k++)
+    {
+        int index = components->memberAt(component, k);
+        if (index == originIndex || !(table.get(k) > 0.0))
+            continue;
+        last = index;
+        remaining -= table.get(k);
+        if (remaining < 0.0)
+            return index;
+    }
+    return last;
+}
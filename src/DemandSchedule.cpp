@@ -0,0 +1,388 @@
+#include "../include/DemandSchedule.h"
+#include "../include/MappedFile.h"
+#include "../include/TextScanner.h"
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <charconv>
+#include <algorithm>
+
+static const int MAX_REPORTED_ERRORS = 10;
+static const double DAY = 86400.0;
+
+// "3600", "1:00" or "01:00:00" -> seconds
+static bool parseTime(const string &text, double &seconds)
+{
+    if (text.find(':') == string::npos)
+    {
+        from_chars_result result = from_chars(text.data(), text.data() + text.size(), seconds);
+        return result.ec == errc() && result.ptr == text.data() + text.size() && seconds >= 0.0;
+    }
+
+    seconds = 0.0;
+    int fields = 0;
+    const char *p = text.data();
+    const char *end = p + text.size();
+    while (p <= end && fields < 3)
+    {
+        int value;
+        from_chars_result result = from_chars(p, end, value);
+        if (result.ec != errc() || value < 0)
+            return false;
+        seconds = seconds * 60.0 + value;
+        fields++;
+
+        p = result.ptr;
+        if (p == end)
+            break;
+        if (*p != ':')
+            return false;
+        p++;
+    }
+    if (p != end || fields < 2)
+        return false;
+    if (fields == 2)
+        seconds *= 60.0; // hh:mm
+    return true;
+}
+
+DemandSchedule::DemandSchedule() : startClock(0.0), period(DAY), generated(0) {}
+
+void DemandSchedule::clear()
+{
+    profiles.clear();
+    flows.clear();
+    startClock = 0.0;
+    period = DAY;
+    arrivals.clear();
+    generated = 0;
+}
+
+bool DemandSchedule::loadFromFile(const string &fileName, const Graph &map, const ReachabilityIndex &reachability)
+{
+    MappedFile file;
+    if (!file.open(fileName))
+        return false;
+
+    TextScanner scanner(file.getData(), file.getData() + file.size());
+
+    vector<RateProfile> loadedProfiles;
+    vector<DemandFlow> loadedFlows;
+    double loadedStart = 0.0;
+    double loadedPeriod = DAY;
+    int skipped = 0;
+
+    string keyword;
+    while (!scanner.atEnd())
+    {
+        int line = scanner.getLine();
+        int column = scanner.getColumn();
+        string token = scanner.peekToken();
+        scanner.readWord(keyword);
+
+        if (keyword[0] == '#')
+        {
+            scanner.skipLine();
+            continue;
+        }
+
+        const char *expected = nullptr;
+        string word;
+        if (keyword == "start" || keyword == "period")
+        {
+            double seconds;
+            int errorLine = scanner.getLine();
+            int errorColumn = scanner.getColumn();
+            token = scanner.peekToken();
+            if (!scanner.readWord(word) || !parseTime(word, seconds) || (keyword == "period" && seconds <= 0.0))
+            {
+                cout << "Error: " << fileName << ":" << errorLine << ":" << errorColumn << ": expected a time after \"" << keyword << "\", found " << token << endl;
+                return false;
+            }
+            (keyword == "start" ? loadedStart : loadedPeriod) = seconds;
+        }
+        else if (keyword == "profile")
+        {
+            // Times are read as whole words (they may be hh:mm), so the position and token of
+            // the failing read are kept before each one
+            RateProfile profile;
+            int steps = 0;
+            int errorLine = scanner.getLine();
+            int errorColumn = scanner.getColumn();
+            token = scanner.peekToken();
+            if (!scanner.readWord(profile.name))
+                expected = "a profile name";
+            else
+            {
+                errorLine = scanner.getLine();
+                errorColumn = scanner.getColumn();
+                token = scanner.peekToken();
+                if (!scanner.readInt(steps) || steps < 1)
+                    expected = "the number of steps";
+            }
+
+            for (int i = 0; !expected && i < steps; i++)
+            {
+                double time, factor;
+                errorLine = scanner.getLine();
+                errorColumn = scanner.getColumn();
+                token = scanner.peekToken();
+                if (!scanner.readWord(word) || !parseTime(word, time))
+                    expected = "a step time";
+                else if (!profile.starts.empty() && time <= profile.starts.back())
+                    expected = "step times in ascending order";
+                else
+                {
+                    errorLine = scanner.getLine();
+                    errorColumn = scanner.getColumn();
+                    token = scanner.peekToken();
+                    if (!scanner.readDouble(factor) || factor < 0.0)
+                        expected = "a rate factor";
+                }
+
+                if (!expected)
+                {
+                    profile.starts.push_back(time);
+                    profile.factors.push_back(factor);
+                }
+            }
+
+            if (expected)
+            {
+                cout << "Error: " << fileName << ":" << errorLine << ":" << errorColumn << ": expected " << expected << ", found " << token << endl;
+                return false;
+            }
+
+            // Names must be unique within the file as it is being loaded
+            bool duplicate = false;
+            for (const RateProfile &existing : loadedProfiles)
+                duplicate |= existing.name == profile.name;
+            if (duplicate)
+            {
+                cout << "Error: " << fileName << ":" << line << ":" << column << ": profile \"" << profile.name << "\" defined twice" << endl;
+                return false;
+            }
+            loadedProfiles.push_back(profile);
+        }
+        else if (keyword == "od")
+        {
+            DemandFlow flow;
+            double perHour = 0.0;
+            flow.profile = -1;
+            int errorLine = scanner.getLine();
+            int errorColumn = scanner.getColumn();
+            token = scanner.peekToken();
+            if (!scanner.readInt(flow.from))
+                expected = "an origin node";
+            else
+            {
+                errorLine = scanner.getLine();
+                errorColumn = scanner.getColumn();
+                token = scanner.peekToken();
+                if (!scanner.readWord(word))
+                    expected = "a destination node or *";
+                else if (word == "*")
+                    flow.to = -1;
+                else
+                {
+                    from_chars_result result = from_chars(word.data(), word.data() + word.size(), flow.to);
+                    if (result.ec != errc() || result.ptr != word.data() + word.size() || flow.to < 0)
+                        expected = "a destination node or *";
+                }
+            }
+            if (!expected)
+            {
+                errorLine = scanner.getLine();
+                errorColumn = scanner.getColumn();
+                token = scanner.peekToken();
+                if (!scanner.readDouble(perHour) || perHour < 0.0)
+                    expected = "vehicles per hour";
+            }
+
+            if (expected)
+            {
+                cout << "Error: " << fileName << ":" << errorLine << ":" << errorColumn << ": expected " << expected << ", found " << token << endl;
+                return false;
+            }
+            flow.ratePerSecond = perHour / 3600.0;
+
+            // Optional profile name on the same line
+            if (!scanner.atEnd() && scanner.getLine() == line && !scanner.atComment())
+            {
+                int profileColumn = scanner.getColumn();
+                scanner.readWord(word);
+                for (int i = 0; i < loadedProfiles.size(); i++)
+                {
+                    if (loadedProfiles[i].name == word)
+                        flow.profile = i;
+                }
+                if (flow.profile == -1)
+                {
+                    cout << "Error: " << fileName << ":" << line << ":" << profileColumn << ": unknown profile \"" << word << "\" (profiles must come before the flows using them)" << endl;
+                    return false;
+                }
+            }
+
+            // Unknown nodes and pairs without a route are skipped like bad roads in a map
+            int fromIndex = map.indexOf(flow.from);
+            int toIndex = (flow.to == -1) ? -1 : map.indexOf(flow.to);
+            bool valid = fromIndex != -1 && (flow.to == -1 || toIndex != -1) && flow.from != flow.to;
+            if (valid)
+            {
+                if (flow.to == -1)
+                    valid = reachability.getComponentSize(reachability.componentOfNode(fromIndex)) >= 2;
+                else
+                    valid = reachability.canReach(fromIndex, toIndex);
+            }
+
+            if (!valid)
+            {
+                if (skipped++ < MAX_REPORTED_ERRORS)
+                    cout << "Unroutable flow in file at " << fileName << ":" << line << ":" << column << ": " << flow.from << " -> " << (flow.to == -1 ? string("*") : to_string(flow.to)) << endl;
+                continue;
+            }
+            if (flow.ratePerSecond > 0.0)
+                loadedFlows.push_back(flow);
+        }
+        else
+        {
+            cout << "Error: " << fileName << ":" << line << ":" << column << ": expected \"start\", \"period\", \"profile\" or \"od\", found " << token << endl;
+            return false;
+        }
+    }
+
+    if (skipped > MAX_REPORTED_ERRORS)
+        cout << "(" << skipped - MAX_REPORTED_ERRORS << " more unroutable flows skipped)" << endl;
+
+    // Steps are cyclic: before the first step time, the last factor still holds
+    for (RateProfile &profile : loadedProfiles)
+    {
+        if (profile.starts.back() >= loadedPeriod)
+        {
+            cout << "Error: " << fileName << ": profile \"" << profile.name << "\" has a step past the period" << endl;
+            return false;
+        }
+        if (profile.starts[0] > 0.0)
+        {
+            profile.starts.insert(profile.starts.begin(), 0.0);
+            profile.factors.insert(profile.factors.begin(), profile.factors.back());
+        }
+
+        profile.integral = 0.0;
+        for (int i = 0; i < profile.starts.size(); i++)
+        {
+            double end = (i + 1 < profile.starts.size()) ? profile.starts[i + 1] : loadedPeriod;
+            profile.integral += profile.factors[i] * (end - profile.starts[i]);
+        }
+    }
+
+    profiles.swap(loadedProfiles);
+    flows.swap(loadedFlows);
+    startClock = loadedStart;
+    period = loadedPeriod;
+    arrivals.clear();
+    arrivals.resize(flows.size());
+    generated = 0;
+    return true;
+}
+
+double DemandSchedule::nextArrival(const DemandFlow &flow, double after, mt19937 &rng) const
+{
+    // Exp(1) from a 32-bit draw, never log(0)
+    double need = -log((static_cast<double>(rng()) + 0.5) / 4294967296.0) / flow.ratePerSecond;
+
+    if (flow.profile == -1)
+        return after + need;
+
+    // 'need' is now in factor-seconds: walk the steps until their area covers it
+    const RateProfile &profile = profiles[flow.profile];
+    if (!(profile.integral > 0.0))
+        return numeric_limits<double>::infinity();
+
+    double time = after;
+    double periods = floor(need / profile.integral);
+    need -= periods * profile.integral;
+    time += periods * period;
+
+    double phase = fmod(startClock + time, period);
+    int step = static_cast<int>(upper_bound(profile.starts.begin(), profile.starts.end(), phase) - profile.starts.begin()) - 1;
+    int steps = static_cast<int>(profile.starts.size());
+    for (int walked = 0; walked <= 2 * steps + 1; walked++)
+    {
+        double stepEnd = (step + 1 < steps) ? profile.starts[step + 1] : period;
+        double area = profile.factors[step] * (stepEnd - phase);
+        if (profile.factors[step] > 0.0 && need <= area)
+            return time + need / profile.factors[step];
+
+        need -= area;
+        time += stepEnd - phase;
+        phase = stepEnd;
+        if (++step == steps)
+        {
+            step = 0;
+            phase = 0.0;
+        }
+    }
+    return time; // Only reached through rounding when 'need' was a whole period
+}
+
+void DemandSchedule::start(double now, mt19937 &rng)
+{
+    arrivals.clear();
+    for (int i = 0; i < flows.size(); i++)
+    {
+        double first = nextArrival(flows[i], now, rng);
+        if (first != numeric_limits<double>::infinity())
+            arrivals.push(i, first);
+    }
+}
+
+void DemandSchedule::popDue(double now, mt19937 &rng, vector<int> &dueFlows)
+{
+    while (!arrivals.empty() && arrivals.topKey() <= now)
+    {
+        int flow = arrivals.top();
+        dueFlows.push_back(flow);
+        generated++;
+
+        double next = nextArrival(flows[flow], arrivals.topKey(), rng);
+        if (next == numeric_limits<double>::infinity())
+            arrivals.pop();
+        else
+            arrivals.changeKey(flow, next);
+    }
+}
+
+double DemandSchedule::getRate(double time) const
+{
+    double phase = fmod(startClock + time, period);
+    double total = 0.0;
+    for (const DemandFlow &flow : flows)
+    {
+        double factor = 1.0;
+        if (flow.profile != -1)
+        {
+            const RateProfile &profile = profiles[flow.profile];
+            int step = static_cast<int>(upper_bound(profile.starts.begin(), profile.starts.end(), phase) - profile.starts.begin()) - 1;
+            factor = profile.factors[step];
+        }
+        total += flow.ratePerSecond * factor;
+    }
+    return total;
+}
+
+void DemandSchedule::printSummary() const
+{
+    ios::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+
+    int anyDestination = 0;
+    for (const DemandFlow &flow : flows)
+        anyDestination += flow.to == -1;
+
+    cout << "Demand: " << flows.size() << " flows (" << anyDestination << " to any destination), " << profiles.size() << " rate profiles, "
+         << fixed << setprecision(1) << getRate(0.0) * 3600.0 << " vehicles/hour at the start" << endl;
+
+    cout.flags(flags);
+    cout.precision(precision);
+}
@@ -6,45 +6,45 @@ EmergencyManager::EmergencyManager()
     cout << "EmergencyManager initialized" << endl;
 }
 
-void EmergencyManager::addEmergency(Vehicle *vehicle)
+void EmergencyManager::addEmergency(VehicleHandle vehicle, int vehicleID, int priority)
 {
-    if (vehicle == nullptr)
-    {
-        cout << "Error: Cannot add null vehicle to emergency queue!" << endl;
-        return;
-    }
-
-    if (vehicle->getPriority() == 0)
+    if (priority == 0)
     {
         cout << "Error: Cannot add non-emergency vehicle (priority 0) to emergency queue!" << endl;
         return;
     }
 
-    emergencyQueue.push(vehicle);
-    cout << "Emergency Vehicle " << vehicle->getID() << " added to queue (Priority: " << vehicle->getPriority() << ", Queue size: " << emergencyQueue.size() << ")" << endl;
+    emergencyQueue.push(EmergencyEntry(vehicle, vehicleID, priority));
+    cout << "Emergency Vehicle " << vehicleID << " added to queue (Priority: " << priority << ", Queue size: " << emergencyQueue.size() << ")" << endl;
 }
 
-Vehicle *EmergencyManager::getNextEmergency()
+VehicleHandle EmergencyManager::getNextEmergency()
 {
     if (emergencyQueue.empty())
-        return nullptr;
+        return VehicleHandle();
 
-    return emergencyQueue.top();
+    return emergencyQueue.top().vehicle;
 }
 
-Vehicle *EmergencyManager::dispatchEmergency()
+VehicleHandle EmergencyManager::dispatchEmergency()
 {
     if (emergencyQueue.empty())
     {
         cout << "No emergency vehicles to dispatch!" << endl;
-        return nullptr;
+        return VehicleHandle();
     }
 
-    Vehicle *vehicle = emergencyQueue.top();
+    EmergencyEntry entry = emergencyQueue.top();
     emergencyQueue.pop();
 
-    cout << "Emergency Vehicle " << vehicle->getID() << " dispatched (Priority: " << vehicle->getPriority() << ", Remaining: " << emergencyQueue.size() << ")" << endl;
-    return vehicle;
+    cout << "Emergency Vehicle " << entry.vehicleID << " dispatched (Priority: " << entry.priority << ", Remaining: " << emergencyQueue.size() << ")" << endl;
+    return entry.vehicle;
+}
+
+void EmergencyManager::removeEmergency(VehicleHandle vehicle)
+{
+    if (emergencyQueue.erase(vehicle))
+        cout << "Emergency vehicle removed from queue (Remaining: " << emergencyQueue.size() << ")" << endl;
 }
 
 bool EmergencyManager::hasEmergencies() const { return !emergencyQueue.empty(); }
@@ -69,6 +69,6 @@ void EmergencyManager::printQueue() const
     cout << "\n=== EMERGENCY QUEUE ===" << endl;
     cout << "Total emergencies: " << emergencyQueue.size() << endl;
 
-    cout << "Highest priority vehicle: ID " << emergencyQueue.top()->getID() << " (Priority: " << emergencyQueue.top()->getPriority() << ")" << endl;
+    cout << "Highest priority vehicle: ID " << emergencyQueue.top().vehicleID << " (Priority: " << emergencyQueue.top().priority << ")" << endl;
     cout << "=======================\n" << endl;
 }
\ No newline at end of file
@@ -1,221 +1,1130 @@
 #include "../include/Graph.h"
+#include "../include/MappedFile.h"
+#include "../include/TextScanner.h"
 #include <iostream>
-#include <fstream>
 #include <algorithm>
 #include <sstream>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <type_traits>
+
+// Invalid edges in a map file that get their own message; the rest are only counted
+static const int MAX_REPORTED_ERRORS = 10;
+
+// Binary map file: a fixed header, then sections in the order below, each starting on an
+// 8-byte boundary so the mapped arrays are aligned. Native (little-endian) byte order.
+static const char BINARY_MAGIC[4] = {'T', 'S', 'M', 'P'};
+static const uint32_t BINARY_VERSION = 1;
+static const uint32_t FLAG_IDENTITY_IDS = 1;
+static const uint32_t FLAG_AUTO_HEURISTIC = 2;
+
+struct BinaryMapHeader
+{
+    char magic[4];
+    uint32_t version;
+    int32_t numNodes;
+    int32_t numEdges;
+    int32_t numSignals;
+    uint32_t flags;
+    double heuristicScale;
+    uint64_t checksum; // Over the header fields above and every section
+};
+
+// Byte offset of each section, and the file size
+struct BinaryMapLayout
+{
+    size_t nodes, offsets, targets, weights, reverseOffsets, reverseSources, reverseEdges, signals, total;
+};
+
+static_assert(sizeof(BinaryMapHeader) == 40, "binary map header must have no padding");
+static_assert(sizeof(Node) == 12 && is_trivially_copyable<Node>::value, "nodes are mapped as stored");
+static_assert(sizeof(SignalPlacement) == 16, "signal placements are mapped as stored");
+
+static size_t alignSection(size_t at) { return (at + 7) & ~static_cast<size_t>(7); }
+
+static BinaryMapLayout binaryLayout(size_t nodes, size_t edges, size_t signals)
+{
+    BinaryMapLayout layout;
+    layout.nodes = alignSection(sizeof(BinaryMapHeader));
+    layout.offsets = alignSection(layout.nodes + nodes * sizeof(Node));
+    layout.targets = alignSection(layout.offsets + (nodes + 1) * sizeof(int32_t));
+    layout.weights = alignSection(layout.targets + edges * sizeof(int32_t));
+    layout.reverseOffsets = alignSection(layout.weights + edges * sizeof(double));
+    layout.reverseSources = alignSection(layout.reverseOffsets + (nodes + 1) * sizeof(int32_t));
+    layout.reverseEdges = alignSection(layout.reverseSources + edges * sizeof(int32_t));
+    layout.signals = alignSection(layout.reverseEdges + edges * sizeof(int32_t));
+    layout.total = alignSection(layout.signals + signals * sizeof(SignalPlacement));
+    return layout;
+}
 
-Graph::Graph(int n) : numNodes(n)
+// FNV-1a over 64-bit words (the file is a whole number of words), seeded with the header fields
+static uint64_t binaryChecksum(const BinaryMapHeader &header, const char *data, size_t size)
 {
-    if (n > 0)
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t value)
     {
-        for (int i = 0; i < n; i++)
-        {
-            nodes[i] = Node(i);
-        }
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+
+    uint64_t scaleBits;
+    memcpy(&scaleBits, &header.heuristicScale, sizeof(scaleBits));
+    mix(header.version);
+    mix(static_cast<uint32_t>(header.numNodes));
+    mix(static_cast<uint32_t>(header.numEdges));
+    mix(static_cast<uint32_t>(header.numSignals));
+    mix(header.flags);
+    mix(scaleBits);
+
+    for (size_t at = sizeof(BinaryMapHeader); at + sizeof(uint64_t) <= size; at += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, data + at, sizeof(word));
+        mix(word);
     }
+    return hash;
+}
+
+Graph::Graph(int n) : numNodes(0), identityIDs(true), roadsStale(false), version(0), csrDirty(false), heuristicScale(0.0), autoHeuristicScale(true)
+{
+    offsets.assign(1, 0);
+
+    for (int i = 0; i < n; i++)
+        addNode(i);
+
+    freeze();
 }
 
 void Graph::addEdge(int from, int to, double weight, bool bidirect)
 {
-    if (from >= numNodes || from < 0 || to >= numNodes || to < 0)
+    int fromIndex = indexOf(from);
+    int toIndex = indexOf(to);
+
+    if (fromIndex == -1 || toIndex == -1)
     {
         cout << "Error! Invalid node entered in addEdge()" << endl;
         return;
     }
 
-    adjacencyList[from].push_back(Edge(to, weight));
+    if (roadsStale)
+        restoreRoads();
+
+    roads.push_back(RoadSegment(fromIndex, toIndex, weight));
 
     if (bidirect)
-        adjacencyList[to].push_back(Edge(from, weight));
+        roads.push_back(RoadSegment(toIndex, fromIndex, weight));
+
+    csrDirty = true;
+    version++;
 }
 
 void Graph::addNode(int id, float x, float y)
 {
-    nodes[id] = Node(id, x, y);
+    int index = indexOf(id);
+    if (index != -1)
+    {
+        nodes.mutableData()[index] = Node(id, x, y);
+        version++; // Moving a node changes A* estimates
+        return;
+    }
+
+    index = numNodes++;
+    nodes.push_back(Node(id, x, y));
+
+    // The ID map is only needed (and only filled) once some node's ID differs from its index
+    if (identityIDs && id != index)
+    {
+        identityIDs = false;
+        for (int i = 0; i < index; i++)
+            idToIndex[nodes[i].ID] = i;
+    }
+    if (!identityIDs)
+        idToIndex[id] = index;
+
+    csrDirty = true;
+    version++;
+}
+
+void Graph::freeze()
+{
+    if (!csrDirty)
+        return;
+
+    if (roadsStale)
+        restoreRoads();
+
+    // Counting sort of the roads by source node; stable, so each node keeps its insertion order
+    offsets.assign(numNodes + 1, 0);
+    int *offsetData = offsets.mutableData();
+    for (const RoadSegment &road : roads)
+        offsetData[road.from + 1]++;
+
+    for (int i = 0; i < numNodes; i++)
+        offsetData[i + 1] += offsetData[i];
+
+    targets.assign(roads.size(), 0);
+    weights.assign(roads.size(), 0.0);
+    int *targetData = targets.mutableData();
+    double *weightData = weights.mutableData();
+
+    vector<int> next(offsets.begin(), offsets.end() - 1);
+    for (const RoadSegment &road : roads)
+    {
+        int slot = next[road.from]++;
+        targetData[slot] = road.to;
+        weightData[slot] = road.weight;
+    }
+
+    // Same counting sort by destination for the reverse arrays, pointing back at the forward edges
+    reverseOffsets.assign(numNodes + 1, 0);
+    int *reverseOffsetData = reverseOffsets.mutableData();
+    for (int e = 0; e < static_cast<int>(targets.size()); e++)
+        reverseOffsetData[targets[e] + 1]++;
+
+    for (int i = 0; i < numNodes; i++)
+        reverseOffsetData[i + 1] += reverseOffsetData[i];
+
+    reverseSources.assign(targets.size(), 0);
+    reverseEdges.assign(targets.size(), 0);
+    int *sourceData = reverseSources.mutableData();
+    int *edgeData = reverseEdges.mutableData();
+
+    next.assign(reverseOffsets.begin(), reverseOffsets.end() - 1);
+    for (int u = 0; u < numNodes; u++)
+    {
+        for (int e = offsets[u]; e < offsets[u + 1]; e++)
+        {
+            int slot = next[targets[e]]++;
+            sourceData[slot] = u;
+            edgeData[slot] = e;
+        }
+    }
+
+    csrDirty = false;
+
+    if (autoHeuristicScale)
+        heuristicScale = computeAdmissibleScale();
+}
+
+void Graph::restoreRoads()
+{
+    // CSR order keeps each node's insertion order, so refreezing gives the same edge IDs
+    roads.clear();
+    roads.reserve(targets.size());
+    for (int u = 0; u + 1 < static_cast<int>(offsets.size()); u++)
+    {
+        for (int e = offsets[u]; e < offsets[u + 1]; e++)
+            roads.push_back(RoadSegment(u, targets[e], weights[e]));
+    }
+    roadsStale = false;
 }
 
 vector<int> Graph::dijkstraAlgorithm(int start, int end)
 {
-    if (!nodeExists(start) || !nodeExists(end))
+    return findRoute(start, end, RouteAlgorithm::DIJKSTRA);
+}
+
+vector<int> Graph::dijkstraAlgorithm(int start, int end, SearchWorkspace &ws) const
+{
+    return findRoute(start, end, RouteAlgorithm::DIJKSTRA, ws);
+}
+
+vector<int> Graph::findRoute(int start, int end, RouteAlgorithm algorithm)
+{
+    freeze();
+
+    if (algorithm == RouteAlgorithm::BIDIRECTIONAL)
+        return bidirectionalDijkstra(start, end, workspace, reverseWorkspace);
+    return findRoute(start, end, algorithm, workspace);
+}
+
+vector<int> Graph::findRoute(int start, int end, RouteAlgorithm algorithm, SearchWorkspace &ws) const
+{
+    int startIndex = indexOf(start);
+    int endIndex = indexOf(end);
+
+    if (startIndex == -1 || endIndex == -1)
     {
         cout << "Error: Start or end node doesn't exist" << endl;
         return {};
     }
 
-    // Distance array initialized to large value (infinity)
-    unordered_map<int, double> dist;
-    unordered_map<int, int> parent; // To reconstruct path
-
-    // Initialize all distances to infinity
-    for (const auto &nodePair : nodes)
+    if (algorithm == RouteAlgorithm::BIDIRECTIONAL)
     {
-        dist[nodePair.first] = numeric_limits<double>::infinity();
-        parent[nodePair.first] = -1;
+        cout << "Error: Bidirectional search needs two workspaces, use bidirectionalDijkstra()" << endl;
+        return {};
     }
 
+    // Dijkstra is A* with a zero heuristic
+    double scale = (algorithm == RouteAlgorithm::ASTAR) ? heuristicScale : 0.0;
+    sf::Vector2<float> goal = nodes[endIndex].position;
+    auto estimate = [&](int node)
+    {
+        if (scale == 0.0)
+            return 0.0;
+        double dx = nodes[node].position.x - goal.x;
+        double dy = nodes[node].position.y - goal.y;
+        return scale * sqrt(dx * dx + dy * dy);
+    };
+
+    // Fresh stamp: every node reads as infinity / no parent until this search touches it
+    ws.begin(numNodes);
+
     // Distance to source is 0
-    dist[start] = 0;
+    ws.setDistance(startIndex, 0, -1);
 
-    // Min-heap storing {distance, node}
-    MinHeapPQ<pair<double, int>> pq;
+    // Indexed min-heap of node -> distance so far + estimate to go; each node is queued at most once
+    IndexedDaryHeap<double> &pq = ws.queue();
 
     // Push source into heap
-    pq.push({0, start});
+    pq.push(startIndex, estimate(startIndex));
 
     // Process nodes until heap is empty
     while (!pq.empty())
     {
-        // Extract node with minimum distance
-        double d = pq.top().first;
-        int node = pq.top().second;
+        // Extract node with minimum key (always current: improvements move it in place)
+        int node = pq.top();
         pq.pop();
-
-        // Skip if this distance is outdated
-        if (d > dist[node])
-            continue;
+        ws.countSettled();
 
         // Early exit if we reached destination (optimization)
-        if (node == end)
+        if (node == endIndex)
             break;
 
-        // Traverse all adjacent neighbors
-        for (const Edge &edge : getNeighbours(node))
+        double d = ws.distance(node);
+
+        // Traverse all adjacent neighbors (contiguous range in the CSR arrays)
+        for (int e = offsets[node]; e < offsets[node + 1]; e++)
         {
-            int next = edge.destination;
-            double wt = edge.weight;
+            int next = targets[e];
+            double candidate = d + weights[e];
 
-            // Relaxation check
-            if (dist[node] + wt < dist[next])
+            // Relaxation check; also records the parent for path reconstruction
+            if (candidate < ws.distance(next))
             {
-                // Update distance
-                dist[next] = dist[node] + wt;
+                ws.setDistance(next, candidate, node);
+
+                // push() re-queues a node that was already expanded (only possible if the
+                // heuristic is inconsistent), decreaseKey() moves one that is still waiting
+                double key = candidate + estimate(next);
+                if (pq.contains(next))
+                    pq.decreaseKey(next, key);
+                else
+                    pq.push(next, key);
+            }
+        }
+    }
+
+    if (ws.distance(endIndex) == numeric_limits<double>::infinity())
+    {
+        cout << "No path found from " << start << " to " << end << endl;
+        return {};
+    }
+
+    return buildPath(endIndex, ws);
+}
+
+double SignalTiming::waitAt(double t) const
+{
+    if (red <= 0.0)
+        return 0.0;
 
-                // Update parent (for path reconstruction)
-                parent[next] = node;
+    // Position in the cycle, green first; a red arrival waits for the cycle to wrap
+    double cycle = green + red;
+    double x = fmod(t + phase, cycle);
+    if (x < 0.0)
+        x += cycle;
+    return (x < green) ? 0.0 : cycle - x;
+}
+
+vector<int> Graph::timeDependentRoute(int start, int end, double departure, const TravelTimeModel &times, double &arrival)
+{
+    freeze();
+    return timeDependentRoute(start, end, departure, times, arrival, workspace);
+}
+
+vector<int> Graph::timeDependentRoute(int start, int end, double departure, const TravelTimeModel &times, double &arrival, SearchWorkspace &ws) const
+{
+    arrival = numeric_limits<double>::infinity();
+
+    int startIndex = indexOf(start);
+    int endIndex = indexOf(end);
+    if (startIndex == -1 || endIndex == -1)
+    {
+        cout << "Error: Start or end node doesn't exist" << endl;
+        return {};
+    }
+
+    if (times.edgeSeconds.size() != targets.size() || times.signals.size() != static_cast<size_t>(numNodes))
+    {
+        cout << "Error: Travel times were built for a different map" << endl;
+        return {};
+    }
+
+    // A node's label is the time a vehicle leaves it: arrival plus the wait at its signal (none at the end)
+    ws.begin(numNodes);
+    ws.setDistance(startIndex, departure, -1);
+    IndexedDaryHeap<double> &pq = ws.queue();
+    pq.push(startIndex, departure);
+
+    while (!pq.empty())
+    {
+        int node = pq.top();
+        double leave = pq.topKey();
+        pq.pop();
+        ws.countSettled();
+
+        if (node == endIndex)
+            break;
+
+        for (int e = offsets[node]; e < offsets[node + 1]; e++)
+        {
+            int next = targets[e];
+            double candidate = leave + times.edgeSeconds[e];
+            if (next != endIndex)
+                candidate += times.signals[next].waitAt(candidate);
 
-                // Push updated distance into heap
-                pq.push({dist[next], next});
+            if (candidate < ws.distance(next))
+            {
+                ws.setDistance(next, candidate, node);
+                if (pq.contains(next))
+                    pq.decreaseKey(next, candidate);
+                else
+                    pq.push(next, candidate);
             }
         }
     }
 
+    if (ws.distance(endIndex) == numeric_limits<double>::infinity())
+    {
+        cout << "No path found from " << start << " to " << end << endl;
+        return {};
+    }
+
+    arrival = ws.distance(endIndex);
+    return buildPath(endIndex, ws);
+}
+
+double Graph::routeArrival(const vector<int> &path, double departure, const TravelTimeModel &times) const
+{
+    if (times.edgeSeconds.size() != targets.size() || times.signals.size() != static_cast<size_t>(numNodes))
+        return numeric_limits<double>::infinity();
+
+    // Same steps as the search, so a route it found comes out at the same time
+    double t = departure;
+    for (int i = 0; i + 1 < static_cast<int>(path.size()); i++)
+    {
+        int node = indexOf(path[i]);
+        int next = indexOf(path[i + 1]);
+        if (node == -1 || next == -1)
+            return numeric_limits<double>::infinity();
+
+        // Fastest of any parallel roads, as the search would have taken
+        double seconds = numeric_limits<double>::infinity();
+        for (int e = offsets[node]; e < offsets[node + 1]; e++)
+        {
+            if (targets[e] == next)
+                seconds = min(seconds, times.edgeSeconds[e]);
+        }
+
+        if (seconds == numeric_limits<double>::infinity())
+            return seconds;
+
+        t += seconds;
+        if (i + 2 < static_cast<int>(path.size()))
+            t += times.signals[next].waitAt(t);
+    }
+    return t;
+}
+
+vector<int> Graph::buildPath(int endIndex, const SearchWorkspace &ws) const
+{
     // Reconstruct path from end to start using parent pointers
     vector<int> path;
-    if (dist[end] == numeric_limits<double>::infinity())
+    int current = endIndex;
+    while (current != -1)
+    {
+        path.push_back(nodes[current].ID);
+        current = ws.parentOf(current);
+    }
+
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+void Graph::settleTargets(int sourceIndex, const vector<int> &targetIndices, bool backward, SearchWorkspace &ws) const
+{
+    ws.begin(numNodes);
+
+    int remaining = 0;
+    for (int target : targetIndices)
+    {
+        if (target != -1 && ws.markTarget(target))
+            remaining++;
+    }
+
+    ws.setDistance(sourceIndex, 0, -1);
+    IndexedDaryHeap<double> &pq = ws.queue();
+    pq.push(sourceIndex, 0);
+
+    // Plain Dijkstra, but it only stops once the last target comes off the heap
+    while (!pq.empty() && remaining > 0)
+    {
+        int node = pq.top();
+        double d = pq.topKey();
+        pq.pop();
+        ws.countSettled();
+
+        if (ws.isTarget(node))
+            remaining--;
+
+        int first = backward ? reverseOffsets[node] : offsets[node];
+        int last = backward ? reverseOffsets[node + 1] : offsets[node + 1];
+        for (int e = first; e < last; e++)
+        {
+            int next = backward ? reverseSources[e] : targets[e];
+            double candidate = d + weights[backward ? reverseEdges[e] : e];
+
+            if (candidate < ws.distance(next))
+            {
+                ws.setDistance(next, candidate, node);
+                if (pq.contains(next))
+                    pq.decreaseKey(next, candidate);
+                else
+                    pq.push(next, candidate);
+            }
+        }
+    }
+}
+
+vector<vector<int>> Graph::findRoutes(int start, const vector<int> &destinations)
+{
+    freeze();
+    return findRoutes(start, destinations, workspace);
+}
+
+vector<vector<int>> Graph::findRoutes(int start, const vector<int> &destinations, SearchWorkspace &ws) const
+{
+    vector<vector<int>> paths(destinations.size());
+
+    int startIndex = indexOf(start);
+    if (startIndex == -1)
+    {
+        cout << "Error: Start node " << start << " doesn't exist" << endl;
+        return paths;
+    }
+
+    vector<int> targetIndices(destinations.size());
+    for (int i = 0; i < static_cast<int>(destinations.size()); i++)
+    {
+        targetIndices[i] = indexOf(destinations[i]);
+        if (targetIndices[i] == -1)
+            cout << "Error: Destination node " << destinations[i] << " doesn't exist" << endl;
+    }
+
+    settleTargets(startIndex, targetIndices, false, ws);
+
+    // Every path comes out of the same parent array
+    for (int i = 0; i < static_cast<int>(destinations.size()); i++)
+    {
+        int target = targetIndices[i];
+        if (target == -1)
+            continue;
+
+        if (ws.distance(target) == numeric_limits<double>::infinity())
+            cout << "No path found from " << start << " to " << destinations[i] << endl;
+        else
+            paths[i] = buildPath(target, ws);
+    }
+
+    return paths;
+}
+
+vector<vector<double>> Graph::costMatrix(const vector<int> &origins, const vector<int> &destinations)
+{
+    freeze();
+    return costMatrix(origins, destinations, workspace);
+}
+
+vector<vector<double>> Graph::costMatrix(const vector<int> &origins, const vector<int> &destinations, SearchWorkspace &ws) const
+{
+    const double INF = numeric_limits<double>::infinity();
+    vector<vector<double>> costs(origins.size(), vector<double>(destinations.size(), INF));
+
+    vector<int> originIndices(origins.size());
+    vector<int> destinationIndices(destinations.size());
+    for (int i = 0; i < static_cast<int>(origins.size()); i++)
+        originIndices[i] = indexOf(origins[i]);
+    for (int j = 0; j < static_cast<int>(destinations.size()); j++)
+        destinationIndices[j] = indexOf(destinations[j]);
+
+    // Search from whichever side has fewer nodes; backward searches run over the reverse CSR
+    bool backward = destinations.size() < origins.size();
+    const vector<int> &sources = backward ? destinationIndices : originIndices;
+    const vector<int> &sinks = backward ? originIndices : destinationIndices;
+
+    for (int s = 0; s < static_cast<int>(sources.size()); s++)
+    {
+        if (sources[s] == -1)
+            continue;
+
+        settleTargets(sources[s], sinks, backward, ws);
+
+        for (int t = 0; t < static_cast<int>(sinks.size()); t++)
+        {
+            if (sinks[t] == -1)
+                continue;
+
+            if (backward)
+                costs[t][s] = ws.distance(sinks[t]);
+            else
+                costs[s][t] = ws.distance(sinks[t]);
+        }
+    }
+
+    return costs;
+}
+
+vector<int> Graph::bidirectionalDijkstra(int start, int end, SearchWorkspace &forward, SearchWorkspace &backward) const
+{
+    int startIndex = indexOf(start);
+    int endIndex = indexOf(end);
+
+    if (startIndex == -1 || endIndex == -1)
+    {
+        cout << "Error: Start or end node doesn't exist" << endl;
+        return {};
+    }
+
+    forward.begin(numNodes);
+    backward.begin(numNodes);
+    forward.setDistance(startIndex, 0, -1);
+    backward.setDistance(endIndex, 0, -1);
+
+    IndexedDaryHeap<double> &forwardQueue = forward.queue();
+    IndexedDaryHeap<double> &backwardQueue = backward.queue();
+    forwardQueue.push(startIndex, 0);
+    backwardQueue.push(endIndex, 0);
+
+    // Best complete path seen so far: forward chain to meetFrom, road meetFrom -> meetTo, backward chain from meetTo
+    double best = (startIndex == endIndex) ? 0.0 : numeric_limits<double>::infinity();
+    int meetFrom = startIndex;
+    int meetTo = endIndex;
+
+    // Once both frontiers together can't beat the best path, nothing left in the queues can improve it.
+    // If either side runs dry, every path through its reachable set has already been offered.
+    while (!forwardQueue.empty() && !backwardQueue.empty() && forwardQueue.topKey() + backwardQueue.topKey() < best)
+    {
+        bool useForward = forwardQueue.topKey() <= backwardQueue.topKey();
+        SearchWorkspace &ws = useForward ? forward : backward;
+        const SearchWorkspace &other = useForward ? backward : forward;
+        IndexedDaryHeap<double> &pq = ws.queue();
+
+        int node = pq.top();
+        double d = pq.topKey();
+        pq.pop();
+        ws.countSettled();
+
+        int first = useForward ? offsets[node] : reverseOffsets[node];
+        int last = useForward ? offsets[node + 1] : reverseOffsets[node + 1];
+        for (int e = first; e < last; e++)
+        {
+            int next = useForward ? targets[e] : reverseSources[e];
+            double candidate = d + weights[useForward ? e : reverseEdges[e]];
+
+            // Stitch with the other side wherever it has already been
+            double total = candidate + other.distance(next);
+            if (total < best)
+            {
+                best = total;
+                meetFrom = useForward ? node : next;
+                meetTo = useForward ? next : node;
+            }
+
+            if (candidate < ws.distance(next))
+            {
+                ws.setDistance(next, candidate, node);
+                if (pq.contains(next))
+                    pq.decreaseKey(next, candidate);
+                else
+                    pq.push(next, candidate);
+            }
+        }
+    }
+
+    vector<int> path;
+    if (best == numeric_limits<double>::infinity())
     {
         cout << "No path found from " << start << " to " << end << endl;
         return path;
     }
 
-    int current = end;
-    while (current != -1)
+    if (startIndex == endIndex)
     {
-        path.push_back(current);
-        current = parent[current];
+        path.push_back(start);
+        return path;
     }
 
+    // Forward parents lead back to the start, backward parents lead on to the end
+    for (int node = meetFrom; node != -1; node = forward.parentOf(node))
+        path.push_back(nodes[node].ID);
     reverse(path.begin(), path.end());
+    for (int node = meetTo; node != -1; node = backward.parentOf(node))
+        path.push_back(nodes[node].ID);
+
     return path;
 }
 
+void Graph::setHeuristicScale(double scale)
+{
+    heuristicScale = max(0.0, scale);
+    autoHeuristicScale = false;
+    version++; // An inadmissible scale can change which route is found
+}
+
+double Graph::getHeuristicScale() const { return heuristicScale; }
+
+double Graph::computeAdmissibleScale() const
+{
+    // The estimate never overshoots if no road costs less per unit of straight-line length than the scale
+    // Runs over the CSR, so it needs a frozen graph (a binary load has no road list)
+    double scale = numeric_limits<double>::infinity();
+    for (int u = 0; u < numNodes; u++)
+    {
+        for (int e = offsets[u]; e < offsets[u + 1]; e++)
+        {
+            float dx = nodes[u].position.x - nodes[targets[e]].position.x;
+            float dy = nodes[u].position.y - nodes[targets[e]].position.y;
+            double length = sqrt(static_cast<double>(dx) * dx + static_cast<double>(dy) * dy);
+
+            if (length > 0.0)
+                scale = min(scale, weights[e] / length);
+            else if (weights[e] <= 0.0)
+                return 0.0; // A free road between coincident nodes: no positive scale is safe
+        }
+    }
+
+    return (scale == numeric_limits<double>::infinity() || scale < 0.0) ? 0.0 : scale;
+}
+
 bool Graph::nodeExists(int id) const
 {
-    return nodes.find(id) != nodes.end();
+    return indexOf(id) != -1;
+}
+
+int Graph::indexOf(int id) const
+{
+    if (identityIDs)
+        return (id >= 0 && id < numNodes) ? id : -1;
+
+    auto iter = idToIndex.find(id);
+    return (iter != idToIndex.end()) ? iter->second : -1;
 }
 
-const vector<Edge> &Graph::getNeighbours(int id) const
+vector<Edge> Graph::getNeighbours(int id) const
 {
-    static const vector<Edge> empty;
-    if (!nodeExists(id))
+    vector<Edge> neighbours;
+    int index = indexOf(id);
+    if (index == -1)
     {
         cout << "Error: Node " << id << " doesn't exist!" << endl;
-        return empty;
+        return neighbours;
     }
 
-    auto iter = adjacencyList.find(id);
-    if (iter != adjacencyList.end())
-        return iter->second;
+    for (int e = offsets[index]; e < offsets[index + 1]; e++)
+        neighbours.push_back(Edge(nodes[targets[e]].ID, weights[e]));
 
-    return empty; // returning empty vector only if the node does not exist
+    return neighbours;
 }
 
 const Node &Graph::getNode(int id) const
 {
     static const Node invalidNode(-1);
 
-    if (!nodeExists(id))
+    int index = indexOf(id);
+    if (index == -1)
     {
         cout << "Error: Node " << id << " doesn't exist!" << endl;
         return invalidNode;
     }
 
-    auto iter = nodes.find(id);
-    if (iter != nodes.end())
-        return iter->second;
-
-    return invalidNode;
+    return nodes[index];
 }
 
 int Graph::getNumNodes() const { return numNodes; }
+int Graph::getNumEdges() const { return targets.size(); }
 
-const unordered_map<int, Node> &Graph::getAllNodes() const { return nodes; }
+const MappedArray<Node> &Graph::getAllNodes() const { return nodes; }
+
+const vector<SignalPlacement> &Graph::getSignalPlacements() const { return signalPlacements; }
+void Graph::setSignalPlacements(const vector<SignalPlacement> &placements) { signalPlacements = placements; }
+
+bool Graph::setEdgeWeight(int edge, double weight)
+{
+    if (csrDirty || edge < 0 || edge >= static_cast<int>(targets.size()))
+        return false;
+
+    double *weightData = weights.mutableData();
+    if (weightData[edge] == weight)
+        return true;
+
+    if (autoHeuristicScale && weight < weightData[edge])
+    {
+        // Source node: the last one whose edges start at or before this edge
+        int u = static_cast<int>(upper_bound(offsets.begin(), offsets.end(), edge) - offsets.begin()) - 1;
+        float dx = nodes[u].position.x - nodes[targets[edge]].position.x;
+        float dy = nodes[u].position.y - nodes[targets[edge]].position.y;
+        double length = sqrt(static_cast<double>(dx) * dx + static_cast<double>(dy) * dy);
+        if (length > 0.0)
+            heuristicScale = min(heuristicScale, max(0.0, weight / length));
+        else if (weight <= 0.0)
+            heuristicScale = 0.0;
+    }
+
+    weightData[edge] = weight;
+    roadsStale = true; // The road list still has the old weight
+    version++;
+    return true;
+}
+
+uint64_t Graph::computeFingerprint() const
+{
+    // FNV-1a over every road's endpoints and weight, in CSR order
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t value)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    for (int u = 0; u < numNodes; u++)
+    {
+        mix(static_cast<uint64_t>(nodes[u].ID));
+        for (int e = offsets[u]; e < offsets[u + 1]; e++)
+        {
+            double weight = weights[e];
+            uint64_t bits;
+            memcpy(&bits, &weight, sizeof(bits));
+            mix(static_cast<uint64_t>(targets[e]));
+            mix(bits);
+        }
+    }
+    return hash;
+}
+
+int Graph::findEdge(int fromIndex, int toIndex) const
+{
+    for (int e = offsets[fromIndex]; e < offsets[fromIndex + 1]; e++)
+    {
+        if (targets[e] == toIndex)
+            return e;
+    }
+    return -1;
+}
 
 bool Graph::loadFromFile(const string &fileName)
 {
-    ifstream file(fileName);
-    if (!file.is_open())
+    // Mapped and parsed in place: no stream or locale work per number
+    MappedFile file;
+    if (!file.open(fileName))
+        return false;
+
+    const char *begin = file.getData();
+    const char *finish = begin + file.size();
+
+    if (file.size() >= sizeof(BINARY_MAGIC) && memcmp(begin, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0)
     {
-        cout << "Error in opening file " << fileName << endl;
+        file.close();
+        return loadBinary(fileName);
+    }
+
+    TextScanner scanner(begin, finish);
+
+    int count;
+    if (!scanner.readInt(count) || count < 0)
+    {
+        cout << "Error: " << fileName << ":" << scanner.getLine() << ":" << scanner.getColumn() << ": expected the node count, found " << scanner.peekToken() << endl;
         return false;
     }
 
-    file >> numNodes;
+    // Counting pass: one road per line, so the line count sizes the road list up front
+    vector<RoadSegment> loaded;
+    loaded.reserve(2 * TextScanner::countLines(begin, finish));
 
-    nodes.clear();
-    adjacencyList.clear();
+    // Optional "node <id> <x> <y>" lines place nodes; the rest keep the default grid layout
+    vector<sf::Vector2<float>> positions(count);
+    vector<char> placed(count, 0);
 
-    for (int i = 0; i < numNodes; i++)
+    int skipped = 0;
+    while (!scanner.atEnd())
     {
-        // Default positions in a grid (adjusted for 1200x800 SFML window)
-        float x = (i % 4) * 280.0f + 150.0f; // 4 columns
-        float y = (i / 4) * 240.0f + 120.0f;  // 3 rows
-        nodes[i] = Node(i, x, y);
+        int line = scanner.getLine();
+        int column = scanner.getColumn();
+
+        int from, to;
+        double weight;
+        const char *expected = nullptr;
+        string keyword;
+        bool oneWay = false;
+        if (!scanner.readInt(from))
+        {
+            string token = scanner.peekToken();
+            if (!scanner.readWord(keyword) || (keyword != "node" && keyword != "arc"))
+            {
+                cout << "Error: " << fileName << ":" << line << ":" << column << ": expected a start node, \"node\" or \"arc\", found " << token << endl;
+                return false;
+            }
+
+            if (keyword == "node")
+            {
+                int id;
+                double x, y;
+                if (!scanner.readInt(id))
+                    expected = "a node ID";
+                else if (!scanner.readDouble(x))
+                    expected = "an x coordinate";
+                else if (!scanner.readDouble(y))
+                    expected = "a y coordinate";
+
+                if (expected)
+                {
+                    cout << "Error: " << fileName << ":" << scanner.getLine() << ":" << scanner.getColumn() << ": expected " << expected << ", found " << scanner.peekToken() << endl;
+                    return false;
+                }
+
+                if (id < 0 || id >= count)
+                {
+                    if (skipped++ < MAX_REPORTED_ERRORS)
+                        cout << "Invalid node in file at " << fileName << ":" << line << ":" << column << ": " << id << endl;
+                    continue;
+                }
+
+                positions[id] = sf::Vector2<float>(static_cast<float>(x), static_cast<float>(y));
+                placed[id] = 1;
+                continue;
+            }
+
+            // "arc from to weight": a one-way road
+            oneWay = true;
+            if (!scanner.readInt(from))
+                expected = "a start node";
+        }
+
+        if (!expected && !scanner.readInt(to))
+            expected = "an end node";
+        if (!expected && !scanner.readDouble(weight))
+            expected = "a road weight";
+
+        if (expected)
+        {
+            cout << "Error: " << fileName << ":" << scanner.getLine() << ":" << scanner.getColumn() << ": expected " << expected << ", found " << scanner.peekToken() << endl;
+            return false;
+        }
+
+        if (from >= count || to >= count || from < 0 || to < 0)
+        {
+            // Skipped like before, but only the first few are printed
+            if (skipped++ < MAX_REPORTED_ERRORS)
+                cout << "Invalid edge in file at " << fileName << ":" << line << ":" << column << ": " << from << " " << to << endl;
+            continue;
+        }
+
+        // Roads are bidirectional unless given as arcs; node IDs are 0..count-1, so they are already dense indices
+        loaded.push_back(RoadSegment(from, to, weight));
+        if (!oneWay)
+            loaded.push_back(RoadSegment(to, from, weight));
     }
 
-    int from, to;
-    double weight;
-    while (file >> from >> to >> weight)
+    if (skipped > MAX_REPORTED_ERRORS)
+        cout << "(" << skipped - MAX_REPORTED_ERRORS << " more invalid lines skipped)" << endl;
+
+    // Parsed cleanly, so replace the current map
+    nodes.clear();
+    idToIndex.clear();
+    numNodes = 0;
+    identityIDs = true;
+    signalPlacements.clear();
+
+    nodes.reserve(count);
+    for (int i = 0; i < count; i++)
     {
-        if (from >= numNodes || to >= numNodes || from < 0 || to < 0)
+        if (placed[i])
         {
-            cout << "Invalid edge in file: " << from << " " << to << endl;
+            addNode(i, positions[i].x, positions[i].y);
             continue;
         }
-        addEdge(from, to, weight, true); // bidirectional roads
+
+        // Default positions in a grid (adjusted for 1200x800 SFML window)
+        float x = (i % 4) * 280.0f + 150.0f; // 4 columns
+        float y = (i / 4) * 240.0f + 120.0f;  // 3 rows
+        addNode(i, x, y);
     }
 
-    file.close();
+    roads.swap(loaded);
+    roadsStale = false;
+    version++;
+    csrDirty = true; // Rebuild even if the file had no nodes, so no stale CSR survives the reload
+    freeze();
+    image.reset(); // Every array is owned again
+
     cout << "Graph loaded successfully! Total number of nodes: " << numNodes << endl;
     return true;
 }
 
+bool Graph::saveBinary(const string &fileName) const
+{
+    if (!isFrozen())
+    {
+        cout << "Error: Graph must be frozen before saving it" << endl;
+        return false;
+    }
+
+    size_t edges = targets.size();
+    BinaryMapLayout layout = binaryLayout(numNodes, edges, signalPlacements.size());
+
+    BinaryMapHeader header;
+    memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.version = BINARY_VERSION;
+    header.numNodes = numNodes;
+    header.numEdges = static_cast<int32_t>(edges);
+    header.numSignals = static_cast<int32_t>(signalPlacements.size());
+    header.flags = (identityIDs ? FLAG_IDENTITY_IDS : 0) | (autoHeuristicScale ? FLAG_AUTO_HEURISTIC : 0);
+    header.heuristicScale = heuristicScale;
+
+    // Built in memory (padding zeroed) so the checksum covers exactly the bytes written
+    vector<char> buffer(layout.total, 0);
+    char *out = buffer.data();
+    memcpy(out + layout.nodes, nodes.data(), numNodes * sizeof(Node));
+    memcpy(out + layout.offsets, offsets.data(), (numNodes + 1) * sizeof(int32_t));
+    memcpy(out + layout.targets, targets.data(), edges * sizeof(int32_t));
+    memcpy(out + layout.weights, weights.data(), edges * sizeof(double));
+    memcpy(out + layout.reverseOffsets, reverseOffsets.data(), (numNodes + 1) * sizeof(int32_t));
+    memcpy(out + layout.reverseSources, reverseSources.data(), edges * sizeof(int32_t));
+    memcpy(out + layout.reverseEdges, reverseEdges.data(), edges * sizeof(int32_t));
+    if (!signalPlacements.empty())
+        memcpy(out + layout.signals, signalPlacements.data(), signalPlacements.size() * sizeof(SignalPlacement));
+
+    header.checksum = binaryChecksum(header, out, layout.total);
+    memcpy(out, &header, sizeof(header));
+
+    ofstream file(fileName, ios::binary);
+    if (!file.is_open())
+    {
+        cout << "Error in opening file " << fileName << endl;
+        return false;
+    }
+
+    file.write(out, buffer.size());
+    if (!file)
+    {
+        cout << "Error writing binary map to " << fileName << endl;
+        return false;
+    }
+
+    cout << "Binary map saved to: " << fileName << " (" << buffer.size() / 1024 << " KB)" << endl;
+    return true;
+}
+
+bool Graph::loadBinary(const string &fileName, bool verifyChecksum)
+{
+    shared_ptr<MappedFile> mapping = make_shared<MappedFile>();
+    if (!mapping->open(fileName))
+        return false;
+
+    const char *data = mapping->getData();
+    BinaryMapHeader header;
+    if (mapping->size() < sizeof(header) || memcmp(data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0)
+    {
+        cout << "Error: " << fileName << " is not a binary map file" << endl;
+        return false;
+    }
+
+    memcpy(&header, data, sizeof(header));
+    if (header.version != BINARY_VERSION)
+    {
+        cout << "Error: " << fileName << " has binary map version " << header.version << ", expected " << BINARY_VERSION << endl;
+        return false;
+    }
+
+    if (header.numNodes < 0 || header.numEdges < 0 || header.numSignals < 0)
+    {
+        cout << "Error: " << fileName << " is truncated or corrupt" << endl;
+        return false;
+    }
+
+    BinaryMapLayout layout = binaryLayout(header.numNodes, header.numEdges, header.numSignals);
+    if (mapping->size() != layout.total)
+    {
+        cout << "Error: " << fileName << " is truncated or corrupt" << endl;
+        return false;
+    }
+
+    if (verifyChecksum && binaryChecksum(header, data, layout.total) != header.checksum)
+    {
+        cout << "Error: " << fileName << " failed its checksum (file is corrupt)" << endl;
+        return false;
+    }
+
+    // Valid, so replace the current map; every array views its section of the file
+    numNodes = header.numNodes;
+    size_t edges = header.numEdges;
+    nodes.view(reinterpret_cast<const Node *>(data + layout.nodes), numNodes);
+    offsets.view(reinterpret_cast<const int *>(data + layout.offsets), numNodes + 1);
+    targets.view(reinterpret_cast<const int *>(data + layout.targets), edges);
+    weights.view(reinterpret_cast<const double *>(data + layout.weights), edges);
+    reverseOffsets.view(reinterpret_cast<const int *>(data + layout.reverseOffsets), numNodes + 1);
+    reverseSources.view(reinterpret_cast<const int *>(data + layout.reverseSources), edges);
+    reverseEdges.view(reinterpret_cast<const int *>(data + layout.reverseEdges), edges);
+
+    const SignalPlacement *placements = reinterpret_cast<const SignalPlacement *>(data + layout.signals);
+    signalPlacements.assign(placements, placements + header.numSignals);
+
+    idToIndex.clear();
+    identityIDs = (header.flags & FLAG_IDENTITY_IDS) != 0;
+    if (!identityIDs)
+    {
+        for (int i = 0; i < numNodes; i++)
+            idToIndex[nodes[i].ID] = i;
+    }
+
+    heuristicScale = header.heuristicScale;
+    autoHeuristicScale = (header.flags & FLAG_AUTO_HEURISTIC) != 0;
+
+    roads.clear();
+    roads.shrink_to_fit();
+    roadsStale = true;
+    csrDirty = false;
+    version++;
+    image = mapping;
+
+    cout << "Graph mapped from binary file! Total number of nodes: " << numNodes << endl;
+    return true;
+}
+
 void Graph::printGraph() const
 {
     cout << "\n---------- GRAPH STRUCTURE ----------\n";
     cout << "Total number of nodes: " << numNodes << endl;
 
-    for (const auto &nodePair : adjacencyList)
+    for (int u = 0; u < numNodes; u++)
     {
-        int node = nodePair.first;
-        cout << "Node " << node << " -> ";
+        if (offsets[u] == offsets[u + 1])
+            continue;
 
-        for (const Edge &edge : nodePair.second)
+        cout << "Node " << nodes[u].ID << " -> ";
+
+        for (int e = offsets[u]; e < offsets[u + 1]; e++)
         {
-            cout << edge.destination << " (weight: " << edge.weight << ") ";
+            cout << nodes[targets[e]].ID << " (weight: " << weights[e] << ") ";
         }
 
         cout << endl;
     }
 
     cout << "--------------------------------------\n\n";
-}
\ No newline at end of file
+}
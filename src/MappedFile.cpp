@@ -0,0 +1,108 @@
+// <windows.h> has to come before any header that does 'using namespace std', or its 'byte'
+// typedefs clash with std::byte under C++17
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "../include/MappedFile.h"
+#include <iostream>
+
+#ifdef _WIN32
+MappedFile::MappedFile() : data(nullptr), length(0), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr) {}
+#else
+MappedFile::MappedFile() : data(nullptr), length(0), fd(-1) {}
+#endif
+
+MappedFile::~MappedFile() { close(); }
+
+bool MappedFile::open(const string &fileName)
+{
+    close();
+
+#ifdef _WIN32
+    fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        cout << "Error in opening file " << fileName << endl;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+    {
+        cout << "Error: " << fileName << " is empty" << endl;
+        close();
+        return false;
+    }
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void *view = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view)
+    {
+        cout << "Error mapping file " << fileName << endl;
+        close();
+        return false;
+    }
+
+    data = static_cast<const char *>(view);
+    length = static_cast<size_t>(fileSize.QuadPart);
+#else
+    fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        cout << "Error in opening file " << fileName << endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        cout << "Error: " << fileName << " is empty" << endl;
+        close();
+        return false;
+    }
+
+    void *view = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED)
+    {
+        cout << "Error mapping file " << fileName << endl;
+        close();
+        return false;
+    }
+
+    data = static_cast<const char *>(view);
+    length = static_cast<size_t>(info.st_size);
+#endif
+
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (data)
+        UnmapViewOfFile(data);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = INVALID_HANDLE_VALUE;
+#else
+    if (data)
+        munmap(const_cast<char *>(data), length);
+    if (fd != -1)
+        ::close(fd);
+    fd = -1;
+#endif
+
+    data = nullptr;
+    length = 0;
+}
@@ -0,0 +1,247 @@
+#include "../include/NextHopTable.h"
+#include "../include/ParallelFor.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+
+static const char FILE_MAGIC[4] = {'T', 'S', 'N', 'H'};
+static const uint32_t FILE_VERSION = 1;
+
+// magic, version, numNodes, numEdges, fingerprint
+static const size_t HEADER_SIZE = 4 + sizeof(uint32_t) + 2 * sizeof(int32_t) + sizeof(uint64_t);
+
+const int NextHopTable::MAX_NODES;
+const uint16_t NextHopTable::NO_HOP;
+
+NextHopTable::NextHopTable() : graph(nullptr), numNodes(0), numEdges(0), fingerprint(0), hops(nullptr) {}
+
+bool NextHopTable::build(const Graph &map, int threads)
+{
+    if (!map.isFrozen())
+    {
+        cout << "Error: Graph must be frozen before building a next-hop table" << endl;
+        return false;
+    }
+
+    if (map.getNumNodes() > MAX_NODES)
+    {
+        cout << "Error: Next-hop table is limited to " << MAX_NODES << " nodes (map has " << map.getNumNodes() << ")" << endl;
+        return false;
+    }
+
+    if (threads <= 0)
+        threads = max(1u, thread::hardware_concurrency());
+
+    clear();
+    graph = &map;
+    numNodes = map.getNumNodes();
+    numEdges = map.getNumEdges();
+    fingerprint = map.computeFingerprint();
+
+    nodeIDs.resize(numNodes);
+    for (int u = 0; u < numNodes; u++)
+        nodeIDs[u] = map.idOf(u);
+
+    ownedHops.assign(static_cast<size_t>(numNodes) * numNodes, NO_HOP);
+    vector<SearchWorkspace> workspaces(threads);
+
+    // One backward search per destination: in the reverse tree rooted at 'to', each node's
+    // parent is its next hop toward 'to'. Rows are disjoint, so threads never share a write.
+    parallelFor(numNodes, threads, [&](int begin, int end, int t)
+    {
+        SearchWorkspace &ws = workspaces[t];
+        for (int to = begin; to < end; to++)
+        {
+            ws.begin(numNodes);
+            ws.setDistance(to, 0, -1);
+            IndexedDaryHeap<double> &pq = ws.queue();
+            pq.push(to, 0);
+
+            uint16_t *row = ownedHops.data() + static_cast<size_t>(to) * numNodes;
+
+            while (!pq.empty())
+            {
+                int node = pq.top();
+                double d = pq.topKey();
+                pq.pop();
+
+                if (node != to)
+                    row[node] = static_cast<uint16_t>(ws.parentOf(node));
+
+                for (int e = map.reverseBegin(node); e < map.reverseEnd(node); e++)
+                {
+                    int prev = map.reverseSource(e);
+                    double candidate = d + map.edgeWeight(map.reverseEdgeID(e));
+
+                    if (candidate < ws.distance(prev))
+                    {
+                        ws.setDistance(prev, candidate, node);
+                        if (pq.contains(prev))
+                            pq.decreaseKey(prev, candidate);
+                        else
+                            pq.push(prev, candidate);
+                    }
+                }
+            }
+        }
+    });
+
+    hops = ownedHops.data();
+    cout << "Next-hop table built: " << numNodes << " nodes, " << getMemoryBytes() / 1024 << " KB" << endl;
+    return true;
+}
+
+bool NextHopTable::isReady() const { return hops != nullptr; }
+
+void NextHopTable::clear()
+{
+    graph = nullptr;
+    numNodes = 0;
+    numEdges = 0;
+    fingerprint = 0;
+    nodeIDs.clear();
+    hops = nullptr;
+    ownedHops.clear();
+    ownedHops.shrink_to_fit();
+    mapped.close();
+}
+
+vector<int> NextHopTable::findRoute(int start, int end) const
+{
+    if (!isReady())
+    {
+        cout << "Error: Next-hop table has not been built" << endl;
+        return {};
+    }
+
+    int startIndex = graph->indexOf(start);
+    int endIndex = graph->indexOf(end);
+
+    if (startIndex == -1 || endIndex == -1)
+    {
+        cout << "Error: Start or end node doesn't exist" << endl;
+        return {};
+    }
+
+    vector<int> path;
+    path.push_back(nodeIDs[startIndex]);
+
+    // A simple path visits each node at most once; the bound (and the range check) also keep a
+    // corrupt mapped file from sending the walk out of the table or round in circles
+    int node = startIndex;
+    while (node != endIndex && static_cast<int>(path.size()) <= numNodes)
+    {
+        node = nextHop(node, endIndex);
+        if (node < 0 || node >= numNodes)
+            break;
+        path.push_back(nodeIDs[node]);
+    }
+
+    if (node != endIndex)
+    {
+        cout << "No path found from " << start << " to " << end << endl;
+        return {};
+    }
+
+    return path;
+}
+
+bool NextHopTable::saveToFile(const string &fileName) const
+{
+    if (!isReady())
+    {
+        cout << "Error: Next-hop table has not been built" << endl;
+        return false;
+    }
+
+    ofstream file(fileName, ios::binary);
+    if (!file.is_open())
+    {
+        cout << "Error in opening file " << fileName << endl;
+        return false;
+    }
+
+    int32_t header[2] = {numNodes, numEdges};
+    file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    file.write(reinterpret_cast<const char *>(&FILE_VERSION), sizeof(FILE_VERSION));
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(&fingerprint), sizeof(fingerprint));
+    file.write(reinterpret_cast<const char *>(nodeIDs.data()), numNodes * sizeof(int32_t));
+    file.write(reinterpret_cast<const char *>(hops), static_cast<size_t>(numNodes) * numNodes * sizeof(uint16_t));
+
+    if (!file)
+    {
+        cout << "Error writing next-hop table to " << fileName << endl;
+        return false;
+    }
+
+    cout << "Next-hop table saved to: " << fileName << endl;
+    return true;
+}
+
+bool NextHopTable::loadFromFile(const string &fileName, const Graph &map)
+{
+    clear();
+
+    if (!map.isFrozen())
+    {
+        cout << "Error: Graph must be frozen before loading a next-hop table" << endl;
+        return false;
+    }
+
+    if (!mapped.open(fileName))
+        return false;
+
+    const char *data = mapped.getData();
+    if (mapped.size() < HEADER_SIZE || memcmp(data, FILE_MAGIC, 4) != 0)
+    {
+        cout << "Error: " << fileName << " is not a next-hop table file" << endl;
+        mapped.close();
+        return false;
+    }
+
+    uint32_t version;
+    int32_t header[2];
+    uint64_t storedFingerprint;
+    memcpy(&version, data + 4, sizeof(version));
+    memcpy(header, data + 8, sizeof(header));
+    memcpy(&storedFingerprint, data + 16, sizeof(storedFingerprint));
+
+    if (version != FILE_VERSION)
+    {
+        cout << "Error: " << fileName << " is not a next-hop table file" << endl;
+        mapped.close();
+        return false;
+    }
+
+    if (header[0] != map.getNumNodes() || header[1] != map.getNumEdges() || storedFingerprint != map.computeFingerprint())
+    {
+        cout << "Error: " << fileName << " was built for a different map" << endl;
+        mapped.close();
+        return false;
+    }
+
+    int nodes = header[0];
+    size_t expected = HEADER_SIZE + nodes * sizeof(int32_t) + static_cast<size_t>(nodes) * nodes * sizeof(uint16_t);
+    if (mapped.size() != expected)
+    {
+        cout << "Error: " << fileName << " is truncated or corrupt" << endl;
+        mapped.close();
+        return false;
+    }
+
+    nodeIDs.resize(nodes);
+    memcpy(nodeIDs.data(), data + HEADER_SIZE, nodes * sizeof(int32_t));
+
+    graph = &map;
+    numNodes = nodes;
+    numEdges = header[1];
+    fingerprint = storedFingerprint;
+    hops = reinterpret_cast<const uint16_t *>(data + HEADER_SIZE + nodes * sizeof(int32_t));
+
+    cout << "Next-hop table mapped from: " << fileName << endl;
+    return true;
+}
+
+int NextHopTable::getNumNodes() const { return numNodes; }
+size_t NextHopTable::getMemoryBytes() const { return static_cast<size_t>(numNodes) * numNodes * sizeof(uint16_t); }
@@ -0,0 +1,181 @@
+#include "../include/ReachabilityIndex.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+ReachabilityIndex::ReachabilityIndex() : largestComponent(-1) { clear(); }
+
+void ReachabilityIndex::clear()
+{
+    componentOf.clear();
+    componentStart.assign(1, 0);
+    componentNodes.clear();
+    dagOffsets.assign(1, 0);
+    dagTargets.clear();
+    largestComponent = -1;
+}
+
+void ReachabilityIndex::build(const Graph &map)
+{
+    clear();
+
+    int numNodes = map.getNumNodes();
+    componentOf.assign(numNodes, -1);
+
+    // Tarjan with an explicit call stack, so long chains can't overflow the real one
+    vector<int> order(numNodes, -1); // Discovery order, -1 until visited
+    vector<int> low(numNodes, 0);
+    vector<int> nextEdge(numNodes, 0); // Resume point in each node's out-edges
+    vector<int> callStack;
+    vector<int> tarjanStack;
+    vector<char> onStack(numNodes, 0);
+    int counter = 0;
+    int components = 0;
+
+    for (int root = 0; root < numNodes; root++)
+    {
+        if (order[root] != -1)
+            continue;
+
+        callStack.push_back(root);
+        while (!callStack.empty())
+        {
+            int u = callStack.back();
+            if (order[u] == -1)
+            {
+                order[u] = low[u] = counter++;
+                nextEdge[u] = map.edgeBegin(u);
+                tarjanStack.push_back(u);
+                onStack[u] = 1;
+            }
+
+            // Descend into the first unvisited neighbour, if any
+            bool descended = false;
+            while (nextEdge[u] < map.edgeEnd(u))
+            {
+                int v = map.edgeTarget(nextEdge[u]++);
+                if (order[v] == -1)
+                {
+                    callStack.push_back(v);
+                    descended = true;
+                    break;
+                }
+                if (onStack[v])
+                    low[u] = min(low[u], order[v]);
+            }
+            if (descended)
+                continue;
+
+            // All edges done: close a component if u is its root, then return to the caller
+            if (low[u] == order[u])
+            {
+                int member;
+                do
+                {
+                    member = tarjanStack.back();
+                    tarjanStack.pop_back();
+                    onStack[member] = 0;
+                    componentOf[member] = components;
+                } while (member != u);
+                components++;
+            }
+
+            callStack.pop_back();
+            if (!callStack.empty())
+            {
+                int parent = callStack.back();
+                low[parent] = min(low[parent], low[u]);
+            }
+        }
+    }
+
+    // Members grouped by component (counting sort keeps them ascending)
+    componentStart.assign(components + 1, 0);
+    for (int u = 0; u < numNodes; u++)
+        componentStart[componentOf[u] + 1]++;
+    for (int c = 0; c < components; c++)
+        componentStart[c + 1] += componentStart[c];
+
+    componentNodes.resize(numNodes);
+    vector<int> next(componentStart.begin(), componentStart.end() - 1);
+    for (int u = 0; u < numNodes; u++)
+        componentNodes[next[componentOf[u]]++] = u;
+
+    largestComponent = -1;
+    for (int c = 0; c < components; c++)
+    {
+        if (largestComponent == -1 || getComponentSize(c) > getComponentSize(largestComponent))
+            largestComponent = c;
+    }
+
+    // Condensed graph, one entry per distinct (component, component) road
+    dagOffsets.assign(components + 1, 0);
+    vector<int> lastSeen(components, -1);
+    for (int c = 0; c < components; c++)
+    {
+        for (int k = componentStart[c]; k < componentStart[c + 1]; k++)
+        {
+            int u = componentNodes[k];
+            for (int e = map.edgeBegin(u); e < map.edgeEnd(u); e++)
+            {
+                int target = componentOf[map.edgeTarget(e)];
+                if (target != c && lastSeen[target] != c)
+                {
+                    lastSeen[target] = c;
+                    dagTargets.push_back(target);
+                }
+            }
+        }
+        dagOffsets[c + 1] = static_cast<int>(dagTargets.size());
+    }
+}
+
+bool ReachabilityIndex::canReach(int fromIndex, int toIndex) const
+{
+    int from = componentOf[fromIndex];
+    int to = componentOf[toIndex];
+    if (from == to)
+        return true;
+    if (from < to)
+        return false; // Roads between components only lead to lower numbers
+
+    // Depth-first walk of the condensed graph, pruning components numbered below the target
+    vector<char> seen(getNumComponents(), 0);
+    vector<int> stack(1, from);
+    seen[from] = 1;
+    while (!stack.empty())
+    {
+        int c = stack.back();
+        stack.pop_back();
+        for (int k = dagOffsets[c]; k < dagOffsets[c + 1]; k++)
+        {
+            int next = dagTargets[k];
+            if (next == to)
+                return true;
+            if (next > to && !seen[next])
+            {
+                seen[next] = 1;
+                stack.push_back(next);
+            }
+        }
+    }
+    return false;
+}
+
+void ReachabilityIndex::printSummary() const
+{
+    int numNodes = static_cast<int>(componentOf.size());
+    if (numNodes == 0)
+        return;
+
+    int singles = 0;
+    for (int c = 0; c < getNumComponents(); c++)
+        singles += (getComponentSize(c) == 1);
+
+    ios_base::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+    cout << "Road network: " << getNumComponents() << " strongly connected component(s), largest has " << getComponentSize(largestComponent) << " of " << numNodes << " nodes ("
+         << fixed << setprecision(1) << 100.0 * getComponentSize(largestComponent) / numNodes << "%), " << singles << " single-node component(s)" << endl;
+    cout.flags(flags);
+    cout.precision(precision);
+}
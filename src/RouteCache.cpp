@@ -0,0 +1,130 @@
+#include "../include/RouteCache.h"
+#include <iostream>
+#include <iomanip>
+
+RouteCache::RouteCache(int maxEntries) : capacity(maxEntries > 0 ? maxEntries : 0), hand(0), graphVersion(0), hits(0), misses(0), evictions(0), invalidations(0), storedNodes(0) {}
+
+uint64_t RouteCache::makeKey(int origin, int destination)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(origin)) << 32) | static_cast<uint32_t>(destination);
+}
+
+void RouteCache::checkVersion(unsigned long long version)
+{
+    if (version == graphVersion)
+        return;
+
+    if (!entries.empty())
+        invalidations++;
+    clear();
+    graphVersion = version;
+}
+
+shared_ptr<const vector<int>> RouteCache::find(int origin, int destination, unsigned long long version)
+{
+    checkVersion(version);
+
+    auto it = slotOf.find(makeKey(origin, destination));
+    if (it == slotOf.end())
+    {
+        misses++;
+        return nullptr;
+    }
+
+    hits++;
+    Entry &entry = entries[it->second];
+    entry.referenced = true;
+    return entry.path;
+}
+
+shared_ptr<const vector<int>> RouteCache::insert(int origin, int destination, unsigned long long version, vector<int> path)
+{
+    checkVersion(version);
+
+    shared_ptr<const vector<int>> shared = make_shared<const vector<int>>(move(path));
+    if (capacity == 0)
+        return shared;
+
+    uint64_t key = makeKey(origin, destination);
+    auto it = slotOf.find(key);
+    if (it != slotOf.end())
+    {
+        // Already cached (e.g. inserted without a find first); keep the newer path
+        Entry &entry = entries[it->second];
+        storedNodes += static_cast<long long>(shared->size()) - static_cast<long long>(entry.path->size());
+        entry.path = shared;
+        entry.referenced = true;
+        return shared;
+    }
+
+    int slot;
+    if (static_cast<int>(entries.size()) < capacity)
+    {
+        slot = entries.size();
+        entries.push_back({key, shared, false});
+    }
+    else
+    {
+        // Sweep until an entry that hasn't been used since the last pass comes up
+        while (entries[hand].referenced)
+        {
+            entries[hand].referenced = false;
+            hand = (hand + 1) % capacity;
+        }
+
+        slot = hand;
+        hand = (hand + 1) % capacity;
+
+        Entry &victim = entries[slot];
+        slotOf.erase(victim.key);
+        storedNodes -= victim.path->size();
+        evictions++;
+
+        victim = {key, shared, false};
+    }
+
+    slotOf[key] = slot;
+    storedNodes += shared->size();
+    return shared;
+}
+
+void RouteCache::clear()
+{
+    entries.clear();
+    slotOf.clear();
+    hand = 0;
+    storedNodes = 0;
+}
+
+void RouteCache::setCapacity(int maxEntries)
+{
+    capacity = maxEntries > 0 ? maxEntries : 0;
+    clear();
+}
+
+int RouteCache::getSize() const { return entries.size(); }
+int RouteCache::getCapacity() const { return capacity; }
+long long RouteCache::getHits() const { return hits; }
+long long RouteCache::getMisses() const { return misses; }
+long long RouteCache::getEvictions() const { return evictions; }
+long long RouteCache::getInvalidations() const { return invalidations; }
+
+double RouteCache::getHitRate() const
+{
+    long long lookups = hits + misses;
+    return lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
+}
+
+size_t RouteCache::getMemoryBytes() const
+{
+    // Per route: the entry, the shared vector with its control block, and a hash map node + bucket
+    size_t perRoute = sizeof(Entry) + sizeof(vector<int>) + 16 + sizeof(pair<uint64_t, int>) + 2 * sizeof(void *);
+    return entries.size() * perRoute + storedNodes * sizeof(int);
+}
+
+void RouteCache::printStats() const
+{
+    cout << "Route cache: " << entries.size() << "/" << capacity << " routes, " << hits << " hits, " << misses << " misses ("
+         << fixed << setprecision(1) << getHitRate() * 100.0 << "% hit rate), " << evictions << " evictions, "
+         << invalidations << " invalidations, ~" << getMemoryBytes() / 1024 << " KB" << endl;
+}
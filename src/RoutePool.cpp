@@ -0,0 +1,181 @@
+#include "../include/RoutePool.h"
+#include <iostream>
+
+// Compaction only pays off once a good share of the arena is dead
+static const int MIN_DEAD_NODES = 1024;
+
+RoutePool::RoutePool() : liveRoutes(0), deadNodes(0) {}
+
+uint64_t RoutePool::hashPath(const vector<int> &path)
+{
+    // FNV-1a over the node IDs
+    uint64_t hash = 14695981039346656037ULL;
+    for (int node : path)
+    {
+        hash ^= static_cast<uint32_t>(node);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool RoutePool::matches(int route, const vector<int> &path) const
+{
+    if (routeLengths[route] != static_cast<int>(path.size()))
+        return false;
+
+    const int *stored = arena.data() + routeStarts[route];
+    for (int i = 0; i < routeLengths[route]; i++)
+    {
+        if (stored[i] != path[i])
+            return false;
+    }
+    return true;
+}
+
+int RoutePool::intern(const vector<int> &path)
+{
+    if (path.empty())
+        return -1;
+
+    uint64_t hash = hashPath(path);
+    auto range = byHash.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (matches(it->second, path))
+        {
+            refCounts[it->second]++;
+            uses[it->second]++;
+            return it->second;
+        }
+    }
+
+    int route;
+    if (!freeIDs.empty())
+    {
+        route = freeIDs.back();
+        freeIDs.pop_back();
+    }
+    else
+    {
+        route = routeStarts.size();
+        routeStarts.push_back(0);
+        routeLengths.push_back(0);
+        refCounts.push_back(0);
+        hashes.push_back(0);
+        uses.push_back(0);
+    }
+
+    routeStarts[route] = arena.size();
+    routeLengths[route] = path.size();
+    refCounts[route] = 1;
+    hashes[route] = hash;
+    uses[route] = 1;
+    arena.insert(arena.end(), path.begin(), path.end());
+
+    byHash.emplace(hash, route);
+    liveRoutes++;
+    return route;
+}
+
+void RoutePool::acquire(int route)
+{
+    if (route < 0)
+        return;
+    refCounts[route]++;
+    uses[route]++;
+}
+
+void RoutePool::release(int route)
+{
+    if (route < 0 || refCounts[route] == 0)
+        return;
+
+    if (--refCounts[route] > 0)
+        return;
+
+    auto range = byHash.equal_range(hashes[route]);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second == route)
+        {
+            byHash.erase(it);
+            break;
+        }
+    }
+
+    freeIDs.push_back(route);
+    liveRoutes--;
+    deadNodes += routeLengths[route];
+
+    if (deadNodes >= MIN_DEAD_NODES && deadNodes * 2 > static_cast<int>(arena.size()))
+        compact();
+}
+
+void RoutePool::compact()
+{
+    // Copy the live routes to a fresh arena in ID order; IDs keep pointing at their routes
+    vector<int> packed;
+    packed.reserve(arena.size() - deadNodes);
+
+    for (int route = 0; route < static_cast<int>(routeStarts.size()); route++)
+    {
+        if (refCounts[route] == 0)
+            continue;
+
+        int start = routeStarts[route];
+        routeStarts[route] = packed.size();
+        packed.insert(packed.end(), arena.begin() + start, arena.begin() + start + routeLengths[route]);
+    }
+
+    arena.swap(packed);
+    deadNodes = 0;
+}
+
+vector<int> RoutePool::getPath(int route) const
+{
+    if (route < 0)
+        return {};
+    return vector<int>(arena.begin() + routeStarts[route], arena.begin() + routeStarts[route] + routeLengths[route]);
+}
+
+int RoutePool::getRouteCount() const { return liveRoutes; }
+int RoutePool::getHolders(int route) const { return refCounts[route]; }
+long long RoutePool::getUses(int route) const { return uses[route]; }
+int RoutePool::getArenaSize() const { return arena.size(); }
+
+size_t RoutePool::getMemoryBytes() const
+{
+    // Arena plus the per-route columns and roughly one hash map node + bucket per live route
+    size_t perRoute = 3 * sizeof(int) + sizeof(uint64_t) + sizeof(long long);
+    return arena.capacity() * sizeof(int) + routeStarts.capacity() * perRoute + liveRoutes * (sizeof(pair<uint64_t, int>) + 2 * sizeof(void *));
+}
+
+void RoutePool::clear()
+{
+    arena.clear();
+    routeStarts.clear();
+    routeLengths.clear();
+    refCounts.clear();
+    hashes.clear();
+    uses.clear();
+    byHash.clear();
+    freeIDs.clear();
+    liveRoutes = 0;
+    deadNodes = 0;
+}
+
+void RoutePool::printStats() const
+{
+    int holders = 0;
+    int busiest = -1;
+    for (int route = 0; route < static_cast<int>(refCounts.size()); route++)
+    {
+        holders += refCounts[route];
+        if (refCounts[route] > 0 && (busiest == -1 || refCounts[route] > refCounts[busiest]))
+            busiest = route;
+    }
+
+    cout << "Route pool: " << liveRoutes << " distinct routes for " << holders << " vehicles, " << arena.size() << " nodes in the arena, ~" << getMemoryBytes() / 1024 << " KB" << endl;
+    if (busiest != -1)
+        cout << "Busiest route: " << front(busiest) << " -> " << back(busiest) << " (" << refCounts[busiest] << " vehicles, " << uses[busiest] << " trips since it was interned)" << endl;
+}
@@ -0,0 +1,32 @@
+#include "../include/SearchWorkspace.h"
+
+SearchWorkspace::SearchWorkspace() : currentStamp(0), settledCount(0) {}
+
+void SearchWorkspace::begin(int numNodes)
+{
+    if (numNodes > static_cast<int>(labels.size()))
+        labels.resize(numNodes, {0.0, -1, 0});
+    if (numNodes > static_cast<int>(targetStamps.size()))
+        targetStamps.resize(numNodes, 0);
+    heap.resize(numNodes);
+
+    // On wrap-around every old stamp could collide with a new one, so pay for one full reset
+    if (++currentStamp == 0)
+    {
+        for (Label &label : labels)
+            label.stamp = 0;
+        targetStamps.assign(targetStamps.size(), 0);
+        currentStamp = 1;
+    }
+
+    heap.clear();
+    settledCount = 0;
+}
+
+bool SearchWorkspace::markTarget(int node)
+{
+    if (targetStamps[node] == currentStamp)
+        return false;
+    targetStamps[node] = currentStamp;
+    return true;
+}
@@ -0,0 +1,36 @@
+#include "../include/SignalIndex.h"
+#include <iostream>
+
+SignalIndex::SignalIndex() {}
+
+void SignalIndex::rebuild(const vector<TrafficSignal> &signals, const Graph &map)
+{
+    signalAtNode.assign(map.getNumNodes(), -1);
+
+    for (int i = 0; i < signals.size(); i++)
+    {
+        int nodeID = signals[i].getIntersectionID();
+        int node = map.indexOf(nodeID);
+        if (node == -1)
+        {
+            cout << "Error: Signal " << signals[i].getID() << " is placed on unknown node " << nodeID << endl;
+            continue;
+        }
+
+        if (signalAtNode[node] != -1)
+            cout << "Warning: Node " << nodeID << " has more than one signal, using Signal " << signals[signalAtNode[node]].getID() << endl;
+        else
+            signalAtNode[node] = i;
+    }
+}
+
+void SignalIndex::clear() { signalAtNode.clear(); }
+
+int SignalIndex::find(int nodeIndex) const
+{
+    if (nodeIndex < 0 || nodeIndex >= static_cast<int>(signalAtNode.size()))
+        return -1;
+    return signalAtNode[nodeIndex];
+}
+
+bool SignalIndex::has(int nodeIndex) const { return find(nodeIndex) != -1; }
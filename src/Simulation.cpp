@@ -1,6 +1,5 @@
 #include "../include/Simulation.h"
 #include <iostream>
-#include <cstdlib>
 #include <ctime>
 #include <cmath>
 #include <algorithm>
@@ -21,14 +20,11 @@ sf::Texture Simulation::trafficLightGreen;
 bool Simulation::redLightLoaded = false;
 bool Simulation::greenLightLoaded = false;
 
-Simulation::Simulation() : window(sf::VideoMode({1200, 800}), "Traffic Simulator"), undoStack(100)
+Simulation::Simulation() : engine(static_cast<unsigned int>(time(nullptr))), window(sf::VideoMode({1200, 800}), "Traffic Simulator")
 {
-    nextVehicleID = 1;
-    totalTime = 0.0f;
     isRunning = false;
-    srand(time(nullptr));
-
-    vehicles.reserve(200);
+    mapView = window.getDefaultView();
+    cullMargin = 0.0f;
 
     cout << "\n=== Traffic Simulator - Initialized ===\n" << endl;
 }
@@ -98,68 +94,62 @@ void Simulation::loadAssets()
 
 bool Simulation::loadMap(const string &filename)
 {
-    if (!cityMap.loadFromFile(filename))
-    {
-        cout << "Failed to load map: " << filename << endl;
+    if (!engine.loadMap(filename))
         return false;
-    }
 
-    cout << "City loaded: " << cityMap.getNumNodes() << " nodes\n" << endl;
+    fitViewToMap();
     return true;
 }
 
-void Simulation::initializeSignals()
+void Simulation::fitViewToMap()
 {
-    // 4 traffic signals: 2 manual, 2 automatic
-    signals.push_back(TrafficSignal(1, 1, cityMap.getNode(1).position, 8.0f, 6.0f, false)); // Manual
-    signals.push_back(TrafficSignal(2, 5, cityMap.getNode(5).position, 7.0f, 5.0f, true));  // Auto
-    signals.push_back(TrafficSignal(3, 6, cityMap.getNode(6).position, 6.0f, 6.0f, false)); // Manual
-    signals.push_back(TrafficSignal(4, 9, cityMap.getNode(9).position, 5.0f, 7.0f, true));  // Auto
+    const Graph& cityMap = engine.getMap();
+    const SpatialGrid& grid = engine.getNodeGrid();
+    mapView = window.getDefaultView();
 
-    cout << "Created " << signals.size() << " traffic signals (2 manual, 2 auto)\n" << endl;
-}
+    // A road is drawn while either end is within this distance of the view
+    cullMargin = 0.0f;
+    for (int u = 0; u < cityMap.getNumNodes(); u++)
+    {
+        for (int e = cityMap.edgeBegin(u); e < cityMap.edgeEnd(u); e++)
+        {
+            sf::Vector2<float> d = cityMap.nodeAt(cityMap.edgeTarget(e)).position - cityMap.nodeAt(u).position;
+            cullMargin = max(cullMargin, max(fabs(d.x), fabs(d.y)));
+        }
+    }
 
-void Simulation::spawnInitialVehicles()
-{
-    // Spawn 3 initial regular vehicles
-    vector<int> path1 = cityMap.dijkstraAlgorithm(0, 11);
-    Vehicle car1(nextVehicleID++, path1, 1.0, 0);
-    car1.setPosition(cityMap.getNode(0).position);
-    car1.setStartPosition(cityMap.getNode(0).position);
-    if (path1.size() > 1)
-        car1.setTargetPosition(cityMap.getNode(path1[1]).position);
-    vehicles.push_back(car1);
-    analytics.recordVehicleSpawn(car1.getID(), 0.0f, false);
-
-    vector<int> path2 = cityMap.dijkstraAlgorithm(2, 10);
-    Vehicle car2(nextVehicleID++, path2, 0.8, 0);
-    car2.setPosition(cityMap.getNode(2).position);
-    car2.setStartPosition(cityMap.getNode(2).position);
-    if (path2.size() > 1)
-        car2.setTargetPosition(cityMap.getNode(path2[1]).position);
-    vehicles.push_back(car2);
-    analytics.recordVehicleSpawn(car2.getID(), 0.0f, false);
-
-    vector<int> path3 = cityMap.dijkstraAlgorithm(0, 7);
-    Vehicle car3(nextVehicleID++, path3, 1.2, 0);
-    car3.setPosition(cityMap.getNode(0).position);
-    car3.setStartPosition(cityMap.getNode(0).position);
-    if (path3.size() > 1)
-        car3.setTargetPosition(cityMap.getNode(path3[1]).position);
-    vehicles.push_back(car3);
-    analytics.recordVehicleSpawn(car3.getID(), 0.0f, false);
-
-    cout << "Spawned " << vehicles.size() << " initial vehicles\n" << endl;
+    if (grid.empty())
+        return;
+
+    // Maps laid out for the window (like the built-in grid) keep the default view
+    sf::Vector2<float> low = grid.getBoundsMin();
+    sf::Vector2<float> high = grid.getBoundsMax();
+    sf::Vector2<float> windowSize = mapView.getSize();
+    if (low.x >= 0.0f && low.y >= 0.0f && high.x <= windowSize.x && high.y <= windowSize.y)
+        return;
+
+    // Fit the bounding box plus a margin, keeping the window's aspect ratio
+    float margin = 0.1f * max(high.x - low.x, high.y - low.y) + 40.0f;
+    float width = high.x - low.x + 2 * margin;
+    float height = high.y - low.y + 2 * margin;
+    float aspect = windowSize.x / windowSize.y;
+    if (width / height < aspect)
+        width = height * aspect;
+    else
+        height = width / aspect;
+
+    mapView.setCenter((low + high) / 2.0f);
+    mapView.setSize({width, height});
 }
 
-bool Simulation::hasSignal(int nodeID) const
+void Simulation::findVisibleNodes()
 {
-    for (const auto &signal : signals)
-    {
-        if (signal.getIntersectionID() == nodeID)
-            return true;
-    }
-    return false;
+    sf::Vector2<float> center = mapView.getCenter();
+    sf::Vector2<float> half = mapView.getSize() / 2.0f;
+    float margin = cullMargin + 32.0f; // Intersection circles and labels reach past the node itself
+
+    visibleNodes.clear();
+    engine.getNodeGrid().queryRange(center.x - half.x - margin, center.y - half.y - margin, center.x + half.x + margin, center.y + half.y + margin, visibleNodes);
 }
 
 void Simulation::setFrameRate(int fps)
@@ -173,8 +163,8 @@ void Simulation::run()
     loadAssets();
     
     // Initialize simulation components
-    initializeSignals();
-    spawnInitialVehicles();
+    engine.initializeSignals();
+    engine.spawnInitialVehicles();
     
     // Print controls
     cout << "=== CONTROLS ===" << endl;
@@ -182,6 +172,8 @@ void Simulation::run()
     cout << "A   - Spawn Regular Vehicle" << endl;
     cout << "E   - Spawn Emergency Vehicle" << endl;
     cout << "U   - UNDO last action" << endl;
+    cout << "Click - Spawn Vehicle at an intersection" << endl;
+    cout << "Wheel - Zoom" << endl;
     cout << "ESC - Exit simulation" << endl;
     cout << "================\n" << endl;
     
@@ -190,16 +182,14 @@ void Simulation::run()
     // Main game loop
     while (window.isOpen() && isRunning)
     {
-        float deltaTime = clock.restart().asSeconds();
-        totalTime += deltaTime;
-        undoStack.setTime(totalTime);
+        float frameTime = clock.restart().asSeconds();
         
         handleInput();
-        update(deltaTime);
+        engine.advance(frameTime); // Fixed-size ticks, independent of frame rate
         render();
     }
     
-    emergencyMgr.printQueue();
+    engine.printEmergencyQueue();
 }
 
 void Simulation::handleInput()
@@ -218,21 +208,23 @@ void Simulation::handleInput()
             
             // Toggle signals
             if (keyEvent->code == sf::Keyboard::Key::Num1)
-                toggleSignal(0);
+                engine.toggleSignal(0);
             else if (keyEvent->code == sf::Keyboard::Key::Num2)
-                toggleSignal(1);
+                engine.toggleSignal(1);
             else if (keyEvent->code == sf::Keyboard::Key::Num3)
-                toggleSignal(2);
+                engine.toggleSignal(2);
             else if (keyEvent->code == sf::Keyboard::Key::Num4)
-                toggleSignal(3);
+                engine.toggleSignal(3);
             // Spawn vehicles
             else if (keyEvent->code == sf::Keyboard::Key::A)
-                spawnRegularVehicle();
+                engine.spawnRegularVehicle();
             else if (keyEvent->code == sf::Keyboard::Key::E)
-                spawnEmergencyVehicle();
+                engine.spawnEmergencyVehicle();
+            else if (keyEvent->code == sf::Keyboard::Key::B)
+                engine.spawnRandomBurst(10);
             // Undo
             else if (keyEvent->code == sf::Keyboard::Key::U)
-                undoLastAction();
+                engine.undoLastAction();
             // Exit
             else if (keyEvent->code == sf::Keyboard::Key::Escape)
             {
@@ -240,237 +232,36 @@ void Simulation::handleInput()
                 isRunning = false;
             }
         }
-    }
-}
-
-void Simulation::toggleSignal(int signalIndex)
-{
-    if (signalIndex < 0 || signalIndex >= signals.size()) return;
-    
-    SignalState prevState = signals[signalIndex].getState();
-    signals[signalIndex].toggleLight();
-    SignalState newState = signals[signalIndex].getState();
-    
-    undoStack.push(Action(ActionType::TOGGLE_SIGNAL, signals[signalIndex].getID(), prevState, newState, totalTime));
-    undoStack.printLastAction();
-
-    // Track analytics
-    analytics.recordSignalToggle();
-}
-
-void Simulation::spawnRegularVehicle()
-{
-    // Random start node (not at signal)
-    int startNode = rand() % cityMap.getNumNodes();
-    while (hasSignal(startNode))
-        startNode = rand() % cityMap.getNumNodes();
-    
-    // Random end node (different from start)
-    int endNode = rand() % cityMap.getNumNodes();
-    while (startNode == endNode)
-        endNode = rand() % cityMap.getNumNodes();
-    
-    vector<int> path = cityMap.dijkstraAlgorithm(startNode, endNode);
-    
-    if (!path.empty())
-    {
-        Vehicle newCar(nextVehicleID++, path, 1.0, 0);
-        newCar.setPosition(cityMap.getNode(startNode).position);
-        newCar.setStartPosition(cityMap.getNode(startNode).position);
-        if (path.size() > 1)
-            newCar.setTargetPosition(cityMap.getNode(path[1]).position);
-        
-        vehicles.push_back(newCar);
-        
-        int vehicleIndex = vehicles.size() - 1;
-        undoStack.push(Action(ActionType::SPAWN_VEHICLE, newCar.getID(), vehicleIndex, totalTime));
-
-        // Track analytics
-        analytics.recordVehicleSpawn(newCar.getID(), totalTime, false);
-        
-        cout << "Regular Vehicle " << newCar.getID() << " spawned! Path: " << startNode << " -> " << endNode << endl;
-        undoStack.printLastAction();
-    }
-}
-
-void Simulation::spawnEmergencyVehicle()
-{
-    // Random start node (not at signal)
-    int startNode = rand() % cityMap.getNumNodes();
-    while (hasSignal(startNode))
-        startNode = rand() % cityMap.getNumNodes();
-    
-    // Random end node (different from start)
-    int endNode = rand() % cityMap.getNumNodes();
-    while (startNode == endNode)
-        endNode = rand() % cityMap.getNumNodes();
-    
-    vector<int> path = cityMap.dijkstraAlgorithm(startNode, endNode);
-    
-    if (!path.empty())
-    {
-        int priority = 5 + (rand() % 6); // Priority 5-10
-        string emergencyType = (priority >= 8) ? "Ambulance" : "Police";
-        
-        Vehicle emergency(nextVehicleID++, path, 1.5, priority);
-        emergency.setPosition(cityMap.getNode(startNode).position);
-        emergency.setStartPosition(cityMap.getNode(startNode).position);
-        if (path.size() > 1)
-            emergency.setTargetPosition(cityMap.getNode(path[1]).position);
-        
-        vehicles.push_back(emergency);
-        emergencyMgr.addEmergency(&vehicles.back());
-        
-        int vehicleIndex = vehicles.size() - 1;
-        undoStack.push(Action(ActionType::SPAWN_VEHICLE, emergency.getID(), vehicleIndex, totalTime));
-
-        // Track analytics
-        analytics.recordVehicleSpawn(emergency.getID(), totalTime, true);
-        
-        cout << emergencyType << " (Vehicle " << emergency.getID() << ") spawned! Priority: " << priority << ", Path: " << startNode << " -> " << endNode << endl;
-        undoStack.printLastAction();
-    }
-}
 
-void Simulation::undoLastAction()
-{
-    if (!undoStack.canUndo())
-    {
-        cout << "Nothing to undo!" << endl;
-        return;
-    }
-    
-    Action lastAction = undoStack.undo();
-
-    // Track analytics
-    analytics.recordUndoOperation();
-    
-    if (lastAction.type == ActionType::TOGGLE_SIGNAL)
-    {
-        // Undo signal toggle
-        for (auto& signal : signals)
+        // Click an intersection to send a car from it
+        if (auto click = event->getIf<sf::Event::MouseButtonPressed>())
         {
-            if (signal.getID() == lastAction.targetID)
+            if (click->button == sf::Mouse::Button::Left)
             {
-                signal.setState(lastAction.previousState);
-                cout << "Signal " << lastAction.targetID << " reverted" << endl;
-                break;
+                sf::Vector2<float> point = window.mapPixelToCoords(click->position, mapView);
+                float pickRadius = 24.0f * mapView.getSize().x / window.getDefaultView().getSize().x;
+                int node = engine.nearestNode(point.x, point.y, pickRadius);
+                if (node != -1)
+                    engine.spawnBurst(node, 1);
             }
         }
-    }
-    else if (lastAction.type == ActionType::SPAWN_VEHICLE)
-    {
-        // Undo vehicle spawn
-        bool found = false;
-        
-        for (auto& car : vehicles)
-        {
-            if (car.getID() == lastAction.targetID)
-            {
-                found = true;
-                
-                // Check if vehicle already arrived naturally
-                if (car.hasArrivedDest())
-                {
-                    cout << "Cannot undo Vehicle " << lastAction.targetID << " - already completed its journey!" << endl;
-                    break;
-                }
-                
-                // Mark for removal
-                car.setStatus(VehicleStatus::ARRIVED);
-                vehiclesToRemove.push_back(car.getID());
-                
-                cout << "Vehicle " << lastAction.targetID << " spawn undone (removed from simulation)" << endl;
-                break;
-            }
-        }
-        
-        if (!found)
-            cout << "Warning: Could not find vehicle " << lastAction.targetID << " to undo!" << endl;
-    }
-}
 
-void Simulation::update(float deltaTime)
-{
-    // Update automatic signals
-    for (auto& signal : signals)
-    {
-        if (signal.isAutoMode())
-            signal.updateTimer(deltaTime);
-    }
-    
-    // Update vehicles
-    for (auto& car : vehicles)
-    {
-        if (car.hasArrivedDest())
-            continue;
-        
-        if (car.canMove())
-        {
-            car.updateVisualPosition(deltaTime);
-            
-            if (car.getInterpolation() >= 1.0f)
-            {
-                int currentNodeId = car.getCurrentNode();
-                int nextNodeId = car.getNextNode();
-                
-                if (nextNodeId != -1)
-                {
-                    bool blockedBySignal = false;
-                    
-                    // Emergency vehicles bypass red signals
-                    if (!car.isEmergency())
-                    {
-                        for (auto& signal : signals)
-                        {
-                            if (signal.getIntersectionID() == currentNodeId && signal.getState() == SignalState::RED)
-                            {
-                                signal.addVehicleToQueue(&car);
-                                blockedBySignal = true;
-                                break;
-                            }
-                        }
-                    }
-                    
-                    if (!blockedBySignal)
-                    {
-                        sf::Vector2<float> nextPos = cityMap.getNode(nextNodeId).position;
-                        car.moveToNextNode(nextPos);
-
-                        // Track road usage for analytics
-                        analytics.recordRoadUsage(currentNodeId, nextNodeId);
-                    }
-                }
-                else
-                {
-                    car.setStatus(VehicleStatus::ARRIVED);
-                    analytics.recordVehicleArrival(car.getID(), totalTime);
-                    cout << "Vehicle " << car.getID() << " arrived at destination!" << endl;
-                }
-            }
-        }
-    }
-    
-    // Remove undone vehicles (deferred removal for safety)
-    if (!vehiclesToRemove.empty())
-    {
-        for (int vehicleID : vehiclesToRemove)
+        // Zoom around the cursor
+        if (auto wheel = event->getIf<sf::Event::MouseWheelScrolled>())
         {
-            auto it = remove_if(vehicles.begin(), vehicles.end(), [vehicleID](const Vehicle& v) { return v.getID() == vehicleID; });
-            
-            if (it != vehicles.end())
-            {
-                vehicles.erase(it, vehicles.end());
-                cout << "Vehicle " << vehicleID << " physically removed from simulation" << endl;
-            }
+            sf::Vector2<float> before = window.mapPixelToCoords(wheel->position, mapView);
+            mapView.zoom(wheel->delta > 0 ? 0.8f : 1.25f);
+            sf::Vector2<float> after = window.mapPixelToCoords(wheel->position, mapView);
+            mapView.move(before - after);
         }
-        vehiclesToRemove.clear();
     }
 }
 
 void Simulation::render()
 {
     window.clear(sf::Color(30, 30, 30));
+    window.setView(mapView);
+    findVisibleNodes();
     
     drawRoads();
     drawIntersections();
@@ -483,29 +274,33 @@ void Simulation::render()
 
 void Simulation::drawRoads()
 {
-    for (const auto& nodePair : cityMap.getAllNodes())
+    const Graph& cityMap = engine.getMap();
+
+    // Walk the CSR edge ranges of the nodes in view and submit their roads in a single draw call
+    vector<sf::Vertex> lines;
+    for (int u : visibleNodes)
     {
-        int nodeId = nodePair.first;
-        const Node& node = nodePair.second;
-        
-        for (const Edge& edge : cityMap.getNeighbours(nodeId))
+        const Node& node = cityMap.nodeAt(u);
+
+        for (int e = cityMap.edgeBegin(u); e < cityMap.edgeEnd(u); e++)
         {
-            const Node& neighbor = cityMap.getNode(edge.destination);
-            sf::Vertex line[] = {
-                sf::Vertex{node.position, sf::Color(100, 100, 100)},
-                sf::Vertex{neighbor.position, sf::Color(100, 100, 100)}
-            };
-            window.draw(line, 2, sf::PrimitiveType::Lines);
+            const Node& neighbor = cityMap.nodeAt(cityMap.edgeTarget(e));
+            lines.push_back(sf::Vertex{node.position, sf::Color(100, 100, 100)});
+            lines.push_back(sf::Vertex{neighbor.position, sf::Color(100, 100, 100)});
         }
     }
+
+    if (!lines.empty())
+        window.draw(lines.data(), lines.size(), sf::PrimitiveType::Lines);
 }
 
 void Simulation::drawIntersections()
 {
-    for (const auto& nodePair : cityMap.getAllNodes())
+    const Graph& cityMap = engine.getMap();
+    for (int u : visibleNodes)
     {
-        const Node& node = nodePair.second;
-        
+        const Node& node = cityMap.nodeAt(u);
+
         sf::CircleShape intersection(16);
         intersection.setPosition(node.position - sf::Vector2<float>(16, 16));
         intersection.setFillColor(sf::Color(200, 200, 200));
@@ -527,7 +322,7 @@ void Simulation::drawIntersections()
 
 void Simulation::drawTrafficSignals()
 {
-    for (const auto& signal : signals)
+    for (const auto& signal : engine.getSignals())
     {
         sf::Vector2<float> sigPos = signal.getPosition();
         bool usedSprite = false;
@@ -555,7 +350,7 @@ void Simulation::drawTrafficSignals()
         {
             sf::CircleShape signalCircle(12);
             signalCircle.setPosition(sigPos + sf::Vector2<float>(25, -25));
-            signalCircle.setFillColor(signal.getColor());
+            signalCircle.setFillColor(signal.getState() == SignalState::RED ? sf::Color::Red : sf::Color::Green);
             signalCircle.setOutlineThickness(3);
             signalCircle.setOutlineColor(sf::Color::Black);
             window.draw(signalCircle);
@@ -591,19 +386,19 @@ void Simulation::drawTrafficSignals()
 
 void Simulation::drawVehicles()
 {
-    for (int i = 0; i < vehicles.size(); i++)
+    const VehicleStore& vehicles = engine.getVehicles();
+    for (int row = 0; row < vehicles.size(); row++)
     {
-        const auto& car = vehicles[i];
-        if (car.hasArrivedDest())
+        if (vehicles.hasArrivedDest(row))
             continue;
         
-        sf::Vector2<float> carPos = car.getPosition();
+        sf::Vector2<float> carPos = vehicles.getPosition(row);
         bool drewSprite = false;
         
-        if (car.isEmergency())
+        if (vehicles.isEmergency(row))
         {
             // Emergency vehicle rendering
-            bool useAmbulance = (car.getPriority() >= 8);
+            bool useAmbulance = (vehicles.getPriority(row) >= 8);
             
             if ((useAmbulance && ambulanceLoaded) || (!useAmbulance && policeLoaded))
             {
@@ -614,7 +409,7 @@ void Simulation::drawVehicles()
                 emergencySprite.setScale({0.35f, 0.35f});
                 
                 // Pulsing effect
-                float pulse = sin(totalTime * 8.0f) * 0.3f + 0.7f;
+                float pulse = sin(engine.getTotalTime() * 8.0f) * 0.3f + 0.7f;
                 
                 if (useAmbulance)
                     emergencySprite.setColor(sf::Color(255, static_cast<int>(100 * pulse), static_cast<int>(100 * pulse)));
@@ -627,16 +422,17 @@ void Simulation::drawVehicles()
         }
         else
         {
-            // Regular vehicle rendering
-            if (carTextureLoaded[i % carTextures.size()])
+            // Regular vehicle rendering (colour keyed on ID so it stays stable when rows move)
+            int textureIndex = vehicles.getID(row) % carTextures.size();
+            if (carTextureLoaded[textureIndex])
             {
-                sf::Sprite carSprite(carTextures[i % carTextures.size()]);
+                sf::Sprite carSprite(carTextures[textureIndex]);
                 sf::FloatRect bounds = carSprite.getLocalBounds();
                 carSprite.setOrigin({bounds.size.x / 2.0f, bounds.size.y / 2.0f});
                 carSprite.setPosition(carPos);
                 carSprite.setScale({0.35f, 0.35f});
                 
-                if (car.getStatus() == VehicleStatus::WAITING)
+                if (vehicles.getStatus(row) == VehicleStatus::WAITING)
                     carSprite.setColor(sf::Color(255, 255, 150));
                 else
                     carSprite.setColor(sf::Color::White);
@@ -652,14 +448,14 @@ void Simulation::drawVehicles()
             sf::RectangleShape carRect({20, 12});
             carRect.setPosition(carPos - sf::Vector2<float>(10, 6));
             
-            if (car.isEmergency())
+            if (vehicles.isEmergency(row))
             {
-                if (car.getPriority() >= 8)
+                if (vehicles.getPriority(row) >= 8)
                     carRect.setFillColor(sf::Color(255, 0, 0, 200));
                 else
                     carRect.setFillColor(sf::Color(0, 0, 255, 200));
             }
-            else if (car.getStatus() == VehicleStatus::WAITING)
+            else if (vehicles.getStatus(row) == VehicleStatus::WAITING)
                 carRect.setFillColor(sf::Color::Yellow);
             else
                 carRect.setFillColor(sf::Color::White);
@@ -673,19 +469,23 @@ void Simulation::drawHUD()
 {
     if (!fontLoaded)
         return;
+
+    // Screen space, unaffected by the camera
+    window.setView(window.getDefaultView());
     
-    // Count vehicles by status
-    int moving = 0, waiting = 0, arrived = 0, emergency = 0;
-    for (const auto& car : vehicles)
+    // Count vehicles by status (arrived vehicles are retired from the store, so their count comes from the engine)
+    const VehicleStore& vehicles = engine.getVehicles();
+    int moving = 0, waiting = 0, arrived = engine.getArrivedCount(), emergency = 0;
+    for (int row = 0; row < vehicles.size(); row++)
     {
-        if (car.hasArrivedDest())
-            arrived++;
-        else if (car.isEmergency())
+        if (vehicles.hasArrivedDest(row))
+            continue;
+        else if (vehicles.isEmergency(row))
         {
             emergency++;
             moving++;
         }
-        else if (car.getStatus() == VehicleStatus::WAITING)
+        else if (vehicles.getStatus(row) == VehicleStatus::WAITING)
             waiting++;
         else
             moving++;
@@ -693,7 +493,7 @@ void Simulation::drawHUD()
     
     // Main HUD
     sf::Text hud(font);
-    string hudText = "Moving: " + to_string(moving) + " | Waiting: " + to_string(waiting) + " | Emergency: " + to_string(emergency) + " | Arrived: " + to_string(arrived) + " | Undo: " + to_string(undoStack.size());
+    string hudText = "Moving: " + to_string(moving) + " | Waiting: " + to_string(waiting) + " | Emergency: " + to_string(emergency) + " | Arrived: " + to_string(arrived) + " | Undo: " + to_string(engine.getUndoCount());
     hud.setString(hudText);
     hud.setCharacterSize(22);
     hud.setFillColor(sf::Color::White);
@@ -704,8 +504,8 @@ void Simulation::drawHUD()
     
     // Controls
     sf::Text controls(font);
-    controls.setString("1-4: Toggle Signals | A: Spawn Car | E: Emergency | U: Undo | ESC: Exit");
-    controls.setCharacterSize(18);
+    controls.setString("1-4: Toggle Signals | A: Spawn Car | B: Burst | E: Emergency | U: Undo | Click: Car | Wheel: Zoom | ESC: Exit");
+    controls.setCharacterSize(16);
     controls.setFillColor(sf::Color(200, 200, 200));
     controls.setOutlineColor(sf::Color::Black);
     controls.setOutlineThickness(1);
@@ -713,15 +513,15 @@ void Simulation::drawHUD()
     window.draw(controls);
 }
 
-void Simulation::saveAnalytics(const std::string& filename) { analytics.saveToFile(filename); }
-void Simulation::printAnalytics() const { analytics.printSummary(); }
+void Simulation::saveAnalytics(const std::string& filename) { engine.saveAnalytics(filename); }
+void Simulation::printAnalytics() const { engine.printAnalytics(); }
 
 Simulation::~Simulation()
 {
     cout << "\n=== Simulation Ended ===" << endl;
 
     // Print summary & Save to file
-    analytics.updateStats(vehicles, signals, totalTime); 
-    analytics.printSummary();
+    engine.finalizeAnalytics();
+    engine.printAnalytics();
     saveAnalytics("data/simulation_log.txt");
 }
\ No newline at end of file
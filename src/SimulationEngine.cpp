@@ -0,0 +1,1083 @@
+#include "../include/SimulationEngine.h"
+#include <iostream>
+#include <cstdint>
+#include <algorithm>
+
+// Longest frame the accumulator will catch up on; anything beyond is dropped so a stalled window doesn't spiral
+static const float MAX_FRAME_TIME = 0.25f;
+static const float FREE_FLOW_HOP_TIME = 2.0f;  // Seconds a speed-1 vehicle takes per road (VehicleStore moves it 0.5 * speed per second)
+static const float CONGESTION_SAMPLE_INTERVAL = 1.0f;
+static const double REROUTE_GAIN = 0.1;         // A new route must be this much cheaper than the rest of the old one
+static const int DEMO_MAP_NODES = 12;           // data/roads.txt, which the built-in signals and initial trips are laid out for
+
+// Seconds a speed-1 vehicle really spends per road: whole ticks, stepped the way VehicleStore does it
+// (rounding can cost a tick over FREE_FLOW_HOP_TIME)
+static double roadTimeFor(float tick)
+{
+    float t = 0.0f;
+    int ticks = 0;
+    while (t < 1.0f && ticks * static_cast<double>(tick) < 2.0 * FREE_FLOW_HOP_TIME)
+    {
+        t += 1.0f * tick * 0.5f;
+        ticks++;
+    }
+    return ticks * static_cast<double>(tick);
+}
+
+SimulationEngine::SimulationEngine(unsigned int seed, float tick) : undoStack(100), rng(seed)
+{
+    nextVehicleID = 1;
+    totalTime = 0.0f;
+    tickSize = tick;
+    accumulator = 0.0f;
+    tickCount = 0;
+    routeAlgorithm = RouteAlgorithm::ASTAR;
+    routeSource = RouteSource::SEARCH;
+    routeTableVersion = 0;
+    liveWeights = false;
+    weightInterval = 10.0f;
+    nextCongestionSample = 0.0;
+    nextWeightUpdate = 0.0;
+    reroutesPerTick = 64;
+    rerouteHead = 0;
+    rerouteCount = 0;
+    travelTimesTick = -1;
+    travelTimesVersion = 0;
+    signalAwareRouting = false;
+    roadTime = roadTimeFor(tickSize);
+}
+
+int SimulationEngine::randomInt(int maxExclusive)
+{
+    // Multiply-shift reduction of a 32-bit draw: same sequence on every platform, unlike uniform_int_distribution
+    return static_cast<int>((static_cast<uint64_t>(rng()) * static_cast<uint64_t>(maxExclusive)) >> 32);
+}
+
+int SimulationEngine::randomSpawnNode()
+{
+    // Signals carry no origin weight, so one O(1) draw always lands on a usable node
+    int index = demand.sampleOrigin(rng);
+    return (index == -1) ? -1 : cityMap.idOf(index);
+}
+
+int SimulationEngine::randomDestination(int startNode)
+{
+    int startIndex = cityMap.indexOf(startNode);
+    if (startIndex == -1)
+        return -1;
+
+    int index = demand.sampleDestination(startIndex, rng);
+    return (index == -1) ? -1 : cityMap.idOf(index);
+}
+
+void SimulationEngine::updateSpawnExclusions()
+{
+    travelTimesTick = -1; // Signal phases are read again on the next use
+
+    for (int index : excludedOrigins)
+        demand.setExcluded(index, false);
+    excludedOrigins.clear();
+
+    for (const TrafficSignal &signal : signals)
+    {
+        int index = cityMap.indexOf(signal.getIntersectionID());
+        if (index == -1)
+            continue;
+        demand.setExcluded(index, true);
+        excludedOrigins.push_back(index);
+    }
+}
+
+bool SimulationEngine::setSpawnWeights(int nodeID, double originWeight, double destinationWeight)
+{
+    int index = cityMap.indexOf(nodeID);
+    if (index == -1)
+        return false;
+
+    demand.setOriginWeight(index, originWeight);
+    demand.setDestinationWeight(index, destinationWeight);
+    return true;
+}
+
+void SimulationEngine::step()
+{
+    tickCount++;
+    update(tickSize);
+}
+
+int SimulationEngine::advance(float frameTime)
+{
+    if (frameTime > MAX_FRAME_TIME)
+        frameTime = MAX_FRAME_TIME;
+
+    accumulator += frameTime;
+
+    int ticks = 0;
+    while (accumulator >= tickSize)
+    {
+        step();
+        accumulator -= tickSize;
+        ticks++;
+    }
+    return ticks;
+}
+
+void SimulationEngine::setTickSize(float tick)
+{
+    if (tick <= 0.0f || tickCount > 0)
+    {
+        cout << "Error: Tick size must be positive and set before the simulation starts" << endl;
+        return;
+    }
+    tickSize = tick;
+    roadTime = roadTimeFor(tick);
+    travelTimes.edgeSeconds.clear(); // Road times are rebuilt for the new tick
+}
+
+void SimulationEngine::setRouteAlgorithm(RouteAlgorithm algorithm)
+{
+    // Same route costs either way, but ties can resolve differently
+    if (algorithm != routeAlgorithm)
+        routeCache.clear();
+    routeAlgorithm = algorithm;
+}
+
+RouteAlgorithm SimulationEngine::getRouteAlgorithm() const { return routeAlgorithm; }
+
+bool SimulationEngine::enableHierarchy(const string &cacheFile)
+{
+    routeCache.clear();
+    cityMap.freeze();
+
+    if (!cacheFile.empty() && hierarchy.loadFromFile(cacheFile, cityMap))
+    {
+        routeSource = RouteSource::HIERARCHY;
+        routeTableVersion = cityMap.getVersion();
+        return true;
+    }
+
+    if (!hierarchy.build(cityMap))
+        return false;
+
+    if (!cacheFile.empty())
+        hierarchy.saveToFile(cacheFile);
+
+    routeSource = RouteSource::HIERARCHY;
+    routeTableVersion = cityMap.getVersion();
+    return true;
+}
+
+bool SimulationEngine::enableNextHopTable(const string &cacheFile)
+{
+    routeCache.clear();
+    cityMap.freeze();
+
+    if (!cacheFile.empty() && nextHops.loadFromFile(cacheFile, cityMap))
+    {
+        routeSource = RouteSource::NEXT_HOP_TABLE;
+        routeTableVersion = cityMap.getVersion();
+        return true;
+    }
+
+    if (!nextHops.build(cityMap))
+        return false;
+
+    if (!cacheFile.empty())
+        nextHops.saveToFile(cacheFile);
+
+    routeSource = RouteSource::NEXT_HOP_TABLE;
+    routeTableVersion = cityMap.getVersion();
+    return true;
+}
+
+RouteSource SimulationEngine::getRouteSource() const { return routeSource; }
+
+vector<int> SimulationEngine::computeRoute(int startNode, int endNode)
+{
+    if (routeSource == RouteSource::HIERARCHY)
+        return hierarchy.findRoute(startNode, endNode);
+    if (routeSource == RouteSource::NEXT_HOP_TABLE)
+        return nextHops.findRoute(startNode, endNode);
+    return cityMap.findRoute(startNode, endNode, routeAlgorithm);
+}
+
+unsigned long long SimulationEngine::routeCacheVersion() const
+{
+    // Weight changes (live weights) only affect graph search; a hierarchy or table keeps the costs
+    // it was built with, and switching to one clears the cache anyway
+    return (routeSource == RouteSource::SEARCH) ? cityMap.getVersion() : routeTableVersion;
+}
+
+shared_ptr<const vector<int>> SimulationEngine::findRoute(int startNode, int endNode)
+{
+    unsigned long long version = routeCacheVersion();
+
+    shared_ptr<const vector<int>> cached = routeCache.find(startNode, endNode, version);
+    if (cached)
+        return cached;
+
+    return routeCache.insert(startNode, endNode, version, computeRoute(startNode, endNode));
+}
+
+vector<shared_ptr<const vector<int>>> SimulationEngine::findRoutes(int startNode, const vector<int> &endNodes)
+{
+    unsigned long long version = routeCacheVersion();
+    vector<shared_ptr<const vector<int>>> routes(endNodes.size());
+
+    // Cached routes first; every distinct end node that's left goes into one search
+    vector<int> missing;
+    for (int i = 0; i < static_cast<int>(endNodes.size()); i++)
+    {
+        routes[i] = routeCache.find(startNode, endNodes[i], version);
+        if (!routes[i])
+            missing.push_back(endNodes[i]);
+    }
+
+    if (missing.empty())
+        return routes;
+
+    sort(missing.begin(), missing.end());
+    missing.erase(unique(missing.begin(), missing.end()), missing.end());
+
+    // The hierarchy and the next-hop table answer point-to-point queries faster than a shared tree
+    // would, and so does a guided search when only one end is left
+    vector<vector<int>> paths;
+    if (routeSource == RouteSource::SEARCH && missing.size() > 1)
+        paths = cityMap.findRoutes(startNode, missing);
+    else
+    {
+        for (int endNode : missing)
+            paths.push_back(computeRoute(startNode, endNode));
+    }
+
+    for (int i = 0; i < static_cast<int>(endNodes.size()); i++)
+    {
+        if (routes[i])
+            continue;
+
+        int slot = lower_bound(missing.begin(), missing.end(), endNodes[i]) - missing.begin();
+        routes[i] = routeCache.insert(startNode, endNodes[i], version, paths[slot]);
+    }
+
+    return routes;
+}
+
+void SimulationEngine::setRouteCacheCapacity(int maxRoutes) { routeCache.setCapacity(maxRoutes); }
+const RouteCache &SimulationEngine::getRouteCache() const { return routeCache; }
+
+float SimulationEngine::getTickSize() const { return tickSize; }
+long long SimulationEngine::getTickCount() const { return tickCount; }
+
+bool SimulationEngine::loadMap(const string &filename)
+{
+    if (!cityMap.loadFromFile(filename))
+    {
+        cout << "Failed to load map: " << filename << endl;
+        return false;
+    }
+
+    analytics.setRoadNetwork(&cityMap);
+    nodeGrid.build(cityMap);
+    signalIndex.rebuild(signals, cityMap); // Keyed by the new map's node indices
+    reachability.build(cityMap);
+    reachability.printSummary();
+    demand.build(reachability);
+    demandSchedule.clear(); // Flows name nodes of the old map
+    if (liveWeights)
+        enableLiveWeights(weightInterval, reroutesPerTick); // Restart from the new map's weights
+    excludedOrigins.clear();
+    updateSpawnExclusions();
+    routeSource = RouteSource::SEARCH; // A hierarchy or table only fits the map it was built for
+    nextHops.clear();
+    travelTimes = TravelTimeModel();
+    timedSignalNodes.clear();
+    travelTimesTick = -1;
+
+    cout << "City loaded: " << cityMap.getNumNodes() << " nodes\n" << endl;
+    return true;
+}
+
+void SimulationEngine::initializeSignals()
+{
+    // A binary map can bring its own signals
+    const vector<SignalPlacement> &placements = cityMap.getSignalPlacements();
+    if (!placements.empty())
+    {
+        int automatic = 0;
+        for (const SignalPlacement &placement : placements)
+        {
+            if (!cityMap.nodeExists(placement.node))
+                continue;
+
+            int id = static_cast<int>(signals.size()) + 1;
+            signals.push_back(TrafficSignal(id, placement.node, cityMap.getNode(placement.node).position, placement.greenDuration, placement.redDuration, placement.automatic != 0));
+            automatic += placement.automatic != 0;
+        }
+
+        signalIndex.rebuild(signals, cityMap);
+        updateSpawnExclusions();
+        cout << "Created " << signals.size() << " traffic signals from the map (" << signals.size() - automatic << " manual, " << automatic << " auto)\n" << endl;
+        return;
+    }
+
+    // The built-in layout names nodes of the demo map; elsewhere it would land on arbitrary intersections
+    if (!isDemoMap())
+    {
+        cout << "The map has no signals and isn't the demo map, so no signals were created\n" << endl;
+        return;
+    }
+
+    // 4 traffic signals: 2 manual, 2 automatic
+    signals.push_back(TrafficSignal(1, 1, cityMap.getNode(1).position, 8.0f, 6.0f, false)); // Manual
+    signals.push_back(TrafficSignal(2, 5, cityMap.getNode(5).position, 7.0f, 5.0f, true));  // Auto
+    signals.push_back(TrafficSignal(3, 6, cityMap.getNode(6).position, 6.0f, 6.0f, false)); // Manual
+    signals.push_back(TrafficSignal(4, 9, cityMap.getNode(9).position, 5.0f, 7.0f, true));  // Auto
+
+    signalIndex.rebuild(signals, cityMap);
+    updateSpawnExclusions();
+
+    cout << "Created " << signals.size() << " traffic signals (2 manual, 2 auto)\n" << endl;
+}
+
+void SimulationEngine::addSignal(const TrafficSignal &signal)
+{
+    signals.push_back(signal);
+    signalIndex.rebuild(signals, cityMap);
+    updateSpawnExclusions();
+}
+
+bool SimulationEngine::removeSignal(int signalID)
+{
+    for (int i = 0; i < signals.size(); i++)
+    {
+        if (signals[i].getID() == signalID)
+        {
+            // Let anything queued here go before the signal disappears
+            signals[i].setState(SignalState::GREEN, vehicles);
+            signals.erase(signals.begin() + i);
+            signalIndex.rebuild(signals, cityMap);
+            updateSpawnExclusions();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SimulationEngine::isDemoMap() const
+{
+    // Every node the built-in signals and trips use, on a map the size of data/roads.txt
+    if (cityMap.getNumNodes() != DEMO_MAP_NODES)
+        return false;
+
+    for (int node : {0, 1, 2, 5, 6, 7, 9, 10, 11})
+    {
+        if (!cityMap.nodeExists(node))
+            return false;
+    }
+    return true;
+}
+
+void SimulationEngine::spawnInitialVehicles()
+{
+    if (!isDemoMap())
+    {
+        cout << "Not the demo map, so no initial vehicles were spawned\n" << endl;
+        return;
+    }
+
+    // Spawn 3 initial regular vehicles
+    shared_ptr<const vector<int>> route1 = findRoute(0, 11);
+    const vector<int> &path1 = *route1;
+    Vehicle car1(nextVehicleID++, path1, 1.0, 0);
+    car1.setPosition(cityMap.getNode(0).position);
+    car1.setStartPosition(cityMap.getNode(0).position);
+    if (path1.size() > 1)
+        car1.setTargetPosition(cityMap.getNode(path1[1]).position);
+    vehicles.add(car1);
+    analytics.recordVehicleSpawn(false);
+
+    shared_ptr<const vector<int>> route2 = findRoute(2, 10);
+    const vector<int> &path2 = *route2;
+    Vehicle car2(nextVehicleID++, path2, 0.8, 0);
+    car2.setPosition(cityMap.getNode(2).position);
+    car2.setStartPosition(cityMap.getNode(2).position);
+    if (path2.size() > 1)
+        car2.setTargetPosition(cityMap.getNode(path2[1]).position);
+    vehicles.add(car2);
+    analytics.recordVehicleSpawn(false);
+
+    shared_ptr<const vector<int>> route3 = findRoute(0, 7);
+    const vector<int> &path3 = *route3;
+    Vehicle car3(nextVehicleID++, path3, 1.2, 0);
+    car3.setPosition(cityMap.getNode(0).position);
+    car3.setStartPosition(cityMap.getNode(0).position);
+    if (path3.size() > 1)
+        car3.setTargetPosition(cityMap.getNode(path3[1]).position);
+    vehicles.add(car3);
+    analytics.recordVehicleSpawn(false);
+
+    cout << "Spawned " << vehicles.size() << " initial vehicles\n" << endl;
+}
+
+bool SimulationEngine::hasSignal(int nodeID) const { return signalIndex.has(cityMap.indexOf(nodeID)); }
+
+void SimulationEngine::toggleSignal(int signalIndex)
+{
+    if (signalIndex < 0 || signalIndex >= signals.size()) return;
+    
+    SignalState prevState = signals[signalIndex].getState();
+    signals[signalIndex].toggleLight(vehicles);
+    travelTimesTick = -1;
+    SignalState newState = signals[signalIndex].getState();
+    
+    undoStack.push(Action(ActionType::TOGGLE_SIGNAL, signals[signalIndex].getID(), prevState, newState, totalTime));
+    undoStack.printLastAction();
+
+    // Track analytics
+    analytics.recordSignalToggle();
+}
+
+void SimulationEngine::spawnRegularVehicle()
+{
+    // Random start node (not at signal) and an end it can surely reach
+    int startNode = randomSpawnNode();
+    if (startNode == -1)
+        return;
+    int endNode = randomDestination(startNode);
+    if (endNode == -1)
+        return;
+
+    if (signalAwareRouting && routeSource == RouteSource::SEARCH)
+    {
+        vector<int> path = signalAwareRoute(startNode, endNode);
+        if (!path.empty())
+            addRegularVehicle(startNode, endNode, path);
+        return;
+    }
+    
+    shared_ptr<const vector<int>> route = findRoute(startNode, endNode); // Keeps the path alive if it gets evicted
+    const vector<int> &path = *route;
+    
+    if (!path.empty())
+        addRegularVehicle(startNode, endNode, path);
+}
+
+void SimulationEngine::addRegularVehicle(int startNode, int endNode, const vector<int> &path)
+{
+    // Straight into the store: the path is interned there, not copied per vehicle
+    int vehicleID = nextVehicleID++;
+    sf::Vector2<float> target = (path.size() > 1) ? cityMap.getNode(path[1]).position : sf::Vector2<float>(0.0f, 0.0f);
+    VehicleHandle handle = vehicles.add(vehicleID, path, 1.0f, 0, cityMap.getNode(startNode).position, target, totalTime);
+    undoStack.push(Action(ActionType::SPAWN_VEHICLE, vehicleID, handle, totalTime));
+
+    // ETA with the expected signal waits along the way, whichever router picked the path
+    refreshTravelTimes();
+    double eta = cityMap.routeArrival(path, departureTime(), travelTimes);
+    if (eta != numeric_limits<double>::infinity())
+        vehicles.setExpectedArrival(vehicles.rowOf(handle), static_cast<float>(eta));
+
+    // Track analytics
+    analytics.recordVehicleSpawn(false);
+
+    cout << "Regular Vehicle " << vehicleID << " spawned! Path: " << startNode << " -> " << endNode << endl;
+    undoStack.printLastAction();
+}
+
+int SimulationEngine::spawnBurst(int startNode, int count)
+{
+    if (!cityMap.nodeExists(startNode) || count <= 0)
+        return 0;
+
+    if (reachability.getComponentSize(reachability.componentOfNode(cityMap.indexOf(startNode))) < 2)
+    {
+        cout << "Node " << startNode << " can't reach any other node" << endl;
+        return 0;
+    }
+
+    // Random end nodes (different from start, in its component)
+    vector<int> endNodes(count);
+    for (int &endNode : endNodes)
+        endNode = randomDestination(startNode);
+    if (endNodes[0] == -1)
+    {
+        cout << "No destination weight left near Node " << startNode << endl;
+        return 0;
+    }
+
+    int spawned = spawnTrips(startNode, endNodes);
+    cout << "Burst of " << spawned << " vehicles spawned from Node " << startNode << endl;
+    return spawned;
+}
+
+int SimulationEngine::spawnTrips(int startNode, const vector<int> &endNodes)
+{
+    // Signal-aware routes depend on when the vehicle leaves, so they are neither cached nor shared
+    if (signalAwareRouting && routeSource == RouteSource::SEARCH)
+    {
+        int spawned = 0;
+        for (int endNode : endNodes)
+        {
+            vector<int> path = signalAwareRoute(startNode, endNode);
+            if (path.empty())
+                continue;
+            addRegularVehicle(startNode, endNode, path);
+            spawned++;
+        }
+        return spawned;
+    }
+
+    vector<shared_ptr<const vector<int>>> routes = findRoutes(startNode, endNodes);
+
+    int spawned = 0;
+    for (int i = 0; i < endNodes.size(); i++)
+    {
+        if (routes[i]->empty())
+            continue;
+        addRegularVehicle(startNode, endNodes[i], *routes[i]);
+        spawned++;
+    }
+    return spawned;
+}
+
+bool SimulationEngine::loadDemand(const string &filename)
+{
+    if (!demandSchedule.loadFromFile(filename, cityMap, reachability))
+    {
+        cout << "Failed to load demand: " << filename << endl;
+        return false;
+    }
+
+    demandSchedule.start(totalTime, rng);
+    demandSchedule.printSummary();
+    return true;
+}
+
+void SimulationEngine::spawnDueTrips()
+{
+    dueFlows.clear();
+    demandSchedule.popDue(totalTime, rng, dueFlows);
+    if (dueFlows.empty())
+        return;
+
+    // (start, end) pairs grouped by start, so each start needs one batched route search this tick
+    dueTrips.clear();
+    for (int flowIndex : dueFlows)
+    {
+        const DemandFlow &flow = demandSchedule.getFlow(flowIndex);
+        int endNode = (flow.to == -1) ? randomDestination(flow.from) : flow.to;
+        if (endNode != -1)
+            dueTrips.push_back(make_pair(flow.from, endNode));
+    }
+    stable_sort(dueTrips.begin(), dueTrips.end(), [](const pair<int, int> &a, const pair<int, int> &b) { return a.first < b.first; });
+
+    vector<int> endNodes;
+    for (int first = 0; first < dueTrips.size();)
+    {
+        int startNode = dueTrips[first].first;
+        endNodes.clear();
+        int last = first;
+        while (last < dueTrips.size() && dueTrips[last].first == startNode)
+            endNodes.push_back(dueTrips[last++].second);
+
+        spawnTrips(startNode, endNodes);
+        first = last;
+    }
+}
+
+int SimulationEngine::spawnRandomBurst(int count)
+{
+    // Random start node (not at signal)
+    int startNode = randomSpawnNode();
+    if (startNode == -1)
+        return 0;
+
+    return spawnBurst(startNode, count);
+}
+
+int SimulationEngine::spawnBurstAt(float x, float y, int count)
+{
+    int startNode = nearestNode(x, y);
+    if (startNode == -1)
+        return 0;
+
+    return spawnBurst(startNode, count);
+}
+
+void SimulationEngine::spawnEmergencyVehicle()
+{
+    // Random start node (not at signal) and an end it can surely reach
+    int startNode = randomSpawnNode();
+    if (startNode == -1)
+        return;
+    int endNode = randomDestination(startNode);
+    if (endNode == -1)
+        return;
+    
+    shared_ptr<const vector<int>> route = findRoute(startNode, endNode); // Keeps the path alive if it gets evicted
+    const vector<int> &path = *route;
+    
+    if (!path.empty())
+    {
+        int priority = 5 + randomInt(6); // Priority 5-10
+        string emergencyType = (priority >= 8) ? "Ambulance" : "Police";
+        
+        int vehicleID = nextVehicleID++;
+        sf::Vector2<float> target = (path.size() > 1) ? cityMap.getNode(path[1]).position : sf::Vector2<float>(0.0f, 0.0f);
+        VehicleHandle handle = vehicles.add(vehicleID, path, 1.5f, priority, cityMap.getNode(startNode).position, target, totalTime);
+        emergencyMgr.addEmergency(handle, vehicleID, priority);
+        undoStack.push(Action(ActionType::SPAWN_VEHICLE, vehicleID, handle, totalTime));
+
+        // Track analytics
+        analytics.recordVehicleSpawn(true);
+        
+        cout << emergencyType << " (Vehicle " << vehicleID << ") spawned! Priority: " << priority << ", Path: " << startNode << " -> " << endNode << endl;
+        undoStack.printLastAction();
+    }
+}
+
+void SimulationEngine::undoLastAction()
+{
+    if (!undoStack.canUndo())
+    {
+        cout << "Nothing to undo!" << endl;
+        return;
+    }
+    
+    Action lastAction = undoStack.undo();
+
+    // Track analytics
+    analytics.recordUndoOperation();
+    
+    if (lastAction.type == ActionType::TOGGLE_SIGNAL)
+    {
+        // Undo signal toggle
+        for (auto& signal : signals)
+        {
+            if (signal.getID() == lastAction.targetID)
+            {
+                signal.setState(lastAction.previousState, vehicles);
+                travelTimesTick = -1;
+                cout << "Signal " << lastAction.targetID << " reverted" << endl;
+                break;
+            }
+        }
+    }
+    else if (lastAction.type == ActionType::SPAWN_VEHICLE)
+    {
+        // Undo vehicle spawn
+        int row = vehicles.rowOf(lastAction.vehicle);
+        
+        // A stale handle means the vehicle has already arrived and been retired
+        if (row == -1 || vehicles.hasArrivedDest(row))
+            cout << "Cannot undo Vehicle " << lastAction.targetID << " - already completed its journey!" << endl;
+        else
+        {
+            // Mark for removal
+            vehicles.setStatus(row, VehicleStatus::ARRIVED);
+            vehiclesToRemove.push_back(lastAction.vehicle);
+            
+            cout << "Vehicle " << lastAction.targetID << " spawn undone (removed from simulation)" << endl;
+        }
+    }
+}
+
+void SimulationEngine::update(float deltaTime)
+{
+    // Derived from the tick count rather than summed, so long runs don't drift
+    totalTime = static_cast<float>(tickCount * static_cast<double>(deltaTime));
+    undoStack.setTime(totalTime);
+
+    // Trips from the demand schedule that are due by now
+    if (!demandSchedule.empty())
+        spawnDueTrips();
+
+    // Update automatic signals
+    for (auto& signal : signals)
+    {
+        if (signal.isAutoMode())
+            signal.updateTimer(deltaTime, vehicles);
+    }
+    
+    // Movement pass over the hot columns; rows that reached a node come back in reachedRows
+    reachedRows.clear();
+    vehicles.updatePositions(deltaTime, reachedRows);
+    
+    // Node transitions, only for the vehicles that just reached a node
+    for (int row : reachedRows)
+    {
+        int currentNodeId = vehicles.getCurrentNode(row);
+        int nextNodeId = vehicles.getNextNode(row);
+        
+        if (nextNodeId != -1)
+        {
+            bool blockedBySignal = false;
+            int currentIndex = cityMap.indexOf(currentNodeId);
+            
+            // Emergency vehicles bypass red signals
+            if (!vehicles.isEmergency(row))
+            {
+                int signalAtNode = signalIndex.find(currentIndex);
+                if (signalAtNode != -1 && signals[signalAtNode].getState() == SignalState::RED)
+                {
+                    signals[signalAtNode].addVehicleToQueue(vehicles.handleAt(row), vehicles);
+                    blockedBySignal = true;
+                }
+            }
+            
+            if (!blockedBySignal)
+            {
+                int nextIndex = cityMap.indexOf(nextNodeId);
+                vehicles.moveToNextNode(row, cityMap.nodeAt(nextIndex).position);
+
+                // Track road usage for analytics (per CSR edge)
+                int edge = cityMap.findEdge(currentIndex, nextIndex);
+                analytics.recordRoadUsage(edge);
+                if (liveWeights && edge != -1)
+                    congestion.addEntry(edge);
+            }
+        }
+        else
+        {
+            vehicles.setStatus(row, VehicleStatus::ARRIVED);
+            vehiclesToRetire.push_back(vehicles.handleAt(row));
+            cout << "Vehicle " << vehicles.getID(row) << " arrived at destination!" << endl;
+        }
+    }
+    
+    // Retire arrived vehicles: keep a trip record for analytics and free their rows,
+    // so per-tick work only ever covers vehicles still on the road
+    for (VehicleHandle handle : vehiclesToRetire)
+    {
+        int row = vehicles.rowOf(handle);
+        if (row == -1)
+            continue;
+        
+        analytics.recordTrip(TripRecord(vehicles.getID(row), vehicles.getOriginNode(row), vehicles.getDestNode(row), vehicles.getPriority(row), vehicles.getSpawnTime(row), totalTime, vehicles.getExpectedArrival(row)));
+        if (vehicles.isEmergency(row))
+            emergencyMgr.removeEmergency(handle);
+        vehicles.remove(handle);
+    }
+    vehiclesToRetire.clear();
+    
+    // Remove undone vehicles (deferred removal for safety, swap-and-pop so each is O(1))
+    if (!vehiclesToRemove.empty())
+    {
+        for (VehicleHandle handle : vehiclesToRemove)
+        {
+            int row = vehicles.rowOf(handle);
+            
+            if (row != -1)
+            {
+                int vehicleID = vehicles.getID(row);
+                if (vehicles.isEmergency(row))
+                    emergencyMgr.removeEmergency(handle);
+                vehicles.remove(handle);
+                cout << "Vehicle " << vehicleID << " physically removed from simulation" << endl;
+            }
+        }
+        vehiclesToRemove.clear();
+    }
+
+    // Congestion feedback: occupancy samples, periodic weight updates, then this tick's reroutes
+    if (liveWeights)
+    {
+        if (totalTime >= nextCongestionSample)
+        {
+            sampleCongestion();
+            nextCongestionSample += CONGESTION_SAMPLE_INTERVAL;
+        }
+        if (totalTime >= nextWeightUpdate)
+        {
+            updateLiveWeights();
+            nextWeightUpdate += weightInterval;
+        }
+        processReroutes();
+    }
+}
+
+void SimulationEngine::enableLiveWeights(float updateInterval, int maxReroutesPerTick)
+{
+    if (updateInterval <= 0.0f || maxReroutesPerTick < 0)
+    {
+        cout << "Error: The weight update interval must be positive and the reroute budget non-negative" << endl;
+        return;
+    }
+
+    liveWeights = true;
+    weightInterval = updateInterval;
+    reroutesPerTick = maxReroutesPerTick;
+    nextCongestionSample = totalTime + CONGESTION_SAMPLE_INTERVAL;
+    nextWeightUpdate = totalTime + weightInterval;
+    rerouteQueue.clear();
+    rerouteHead = 0;
+
+    cityMap.freeze();
+    congestion.reset(cityMap, FREE_FLOW_HOP_TIME);
+    edgeIncrease.assign(cityMap.getNumEdges(), 0.0);
+    hasSlowerEdge.assign(cityMap.getNumNodes(), 0);
+
+    if (routeSource != RouteSource::SEARCH)
+        cout << "Note: live weights only reach graph search; the current route source keeps its own costs" << endl;
+}
+
+int SimulationEngine::currentEdge(int row) const
+{
+    int cursor = vehicles.getPathCursor(row);
+    int route = vehicles.getRouteID(row);
+    if (route == -1 || cursor == 0)
+        return -1;
+
+    const RoutePool &routes = vehicles.getRoutes();
+    return cityMap.findEdge(cityMap.indexOf(routes.nodeAt(route, cursor - 1)), cityMap.indexOf(routes.nodeAt(route, cursor)));
+}
+
+void SimulationEngine::sampleCongestion()
+{
+    for (int row = 0; row < vehicles.size(); row++)
+    {
+        if (vehicles.getStatus(row) == VehicleStatus::ARRIVED)
+            continue;
+
+        int edge = currentEdge(row);
+        if (edge != -1)
+            congestion.addOccupancy(edge);
+    }
+    congestion.finishSample();
+}
+
+void SimulationEngine::updateLiveWeights()
+{
+    slowerEdges.clear();
+    congestion.update(cityMap, weightInterval, slowerEdges);
+
+    // A hierarchy or table would hand back the same routes, so there is nothing to reroute to
+    if (slowerEdges.empty() || routeSource != RouteSource::SEARCH)
+        return;
+
+    // Flag the slower roads by ID and by source node (found through the target's in-edges)
+    for (const pair<int, double> &change : slowerEdges)
+    {
+        edgeIncrease[change.first] = change.second;
+        int target = cityMap.edgeTarget(change.first);
+        for (int r = cityMap.reverseBegin(target); r < cityMap.reverseEnd(target); r++)
+        {
+            if (cityMap.reverseEdgeID(r) == change.first)
+                hasSlowerEdge[cityMap.reverseSource(r)] = 1;
+        }
+    }
+
+    // Queue the vehicles whose remaining route (past the node they are committed to) got dearer by
+    // more than a reroute could save; smaller increases can't make another route clearly better
+    rerouteQueue.erase(rerouteQueue.begin(), rerouteQueue.begin() + rerouteHead);
+    rerouteHead = 0;
+
+    const RoutePool &routes = vehicles.getRoutes();
+    for (int row = 0; row < vehicles.size(); row++)
+    {
+        int route = vehicles.getRouteID(row);
+        if (route == -1 || vehicles.getStatus(row) == VehicleStatus::ARRIVED)
+            continue;
+
+        int length = routes.length(route);
+        int from = max(vehicles.getPathCursor(row), 1);
+        double increase = 0.0;
+        for (int i = from; i + 1 < length; i++)
+        {
+            int u = cityMap.indexOf(routes.nodeAt(route, i));
+            if (!hasSlowerEdge[u])
+                continue;
+
+            int edge = cityMap.findEdge(u, cityMap.indexOf(routes.nodeAt(route, i + 1)));
+            if (edge != -1)
+                increase += edgeIncrease[edge];
+        }
+
+        if (increase <= 0.0)
+            continue;
+
+        double remaining = 0.0;
+        for (int i = from; i + 1 < length; i++)
+        {
+            int edge = cityMap.findEdge(cityMap.indexOf(routes.nodeAt(route, i)), cityMap.indexOf(routes.nodeAt(route, i + 1)));
+            if (edge != -1)
+                remaining += cityMap.edgeWeight(edge);
+        }
+        if (increase > REROUTE_GAIN * remaining)
+            rerouteQueue.push_back(vehicles.handleAt(row));
+    }
+
+    for (const pair<int, double> &change : slowerEdges)
+    {
+        edgeIncrease[change.first] = 0.0;
+        int target = cityMap.edgeTarget(change.first);
+        for (int r = cityMap.reverseBegin(target); r < cityMap.reverseEnd(target); r++)
+            hasSlowerEdge[cityMap.reverseSource(r)] = 0;
+    }
+}
+
+void SimulationEngine::setSignalAwareRouting(bool enabled) { signalAwareRouting = enabled; }
+bool SimulationEngine::hasSignalAwareRouting() const { return signalAwareRouting; }
+
+void SimulationEngine::refreshTravelTimes()
+{
+    cityMap.freeze();
+    int numEdges = cityMap.getNumEdges();
+    if (static_cast<int>(travelTimes.edgeSeconds.size()) != numEdges || travelTimesVersion != cityMap.getVersion())
+    {
+        // A road's time grows with its weight over the free-flow weight, as congestion raises it
+        travelTimes.edgeSeconds.assign(numEdges, roadTime);
+        if (liveWeights)
+        {
+            for (int e = 0; e < numEdges; e++)
+            {
+                double base = congestion.getBaseWeight(e);
+                if (base > 0.0)
+                    travelTimes.edgeSeconds[e] = roadTime * cityMap.edgeWeight(e) / base;
+            }
+        }
+        travelTimesVersion = cityMap.getVersion();
+    }
+
+    if (travelTimesTick == tickCount && static_cast<int>(travelTimes.signals.size()) == cityMap.getNumNodes())
+        return;
+
+    if (static_cast<int>(travelTimes.signals.size()) != cityMap.getNumNodes())
+        travelTimes.signals.assign(cityMap.getNumNodes(), SignalTiming());
+    for (int index : timedSignalNodes)
+        travelTimes.signals[index] = SignalTiming();
+    timedSignalNodes.clear();
+
+    for (int i = 0; i < signals.size(); i++)
+    {
+        const TrafficSignal &signal = signals[i];
+        int index = cityMap.indexOf(signal.getIntersectionID());
+        if (index == -1 || signalIndex.find(index) != i)
+            continue;
+
+        // A manual green never turns red by itself
+        bool green = signal.getState() == SignalState::GREEN;
+        if (green && !signal.isAutoMode())
+            continue;
+
+        // Seconds into the green-then-red cycle right now. A manual red is expected to last its
+        // usual red time, like an automatic one that just switched.
+        double greenTime = signal.getGreenDuration();
+        double redTime = signal.getRedDuration();
+        double left = min(max(static_cast<double>(signal.getTimer()), 0.0), green ? greenTime : redTime);
+        double intoCycle = green ? greenTime - left : greenTime + redTime - left;
+
+        travelTimes.signals[index] = SignalTiming(greenTime, redTime, intoCycle - totalTime);
+        timedSignalNodes.push_back(index);
+    }
+    travelTimesTick = tickCount;
+}
+
+double SimulationEngine::departureTime() const
+{
+    // A new vehicle's first move already ends at its second node, and its second move runs from
+    // there to there, so it effectively leaves one road time late
+    return totalTime + roadTime;
+}
+
+vector<int> SimulationEngine::signalAwareRoute(int startNode, int endNode)
+{
+    refreshTravelTimes();
+    double arrival;
+    return cityMap.timeDependentRoute(startNode, endNode, departureTime(), travelTimes, arrival);
+}
+
+double SimulationEngine::pathCost(const vector<int> &path, int from) const
+{
+    double cost = 0.0;
+    for (int i = from; i + 1 < path.size(); i++)
+    {
+        int edge = cityMap.findEdge(cityMap.indexOf(path[i]), cityMap.indexOf(path[i + 1]));
+        cost += (edge == -1) ? numeric_limits<double>::infinity() : cityMap.edgeWeight(edge);
+    }
+    return cost;
+}
+
+void SimulationEngine::processReroutes()
+{
+    size_t end = min(rerouteQueue.size(), rerouteHead + static_cast<size_t>(reroutesPerTick));
+    if (rerouteHead >= end)
+        return;
+
+    // (new start, vehicle row) for this tick's share, grouped by start so each group is one search
+    rerouteStarts.clear();
+    for (; rerouteHead < end; rerouteHead++)
+    {
+        int row = vehicles.rowOf(rerouteQueue[rerouteHead]);
+        if (row == -1 || vehicles.getStatus(row) == VehicleStatus::ARRIVED)
+            continue;
+
+        int route = vehicles.getRouteID(row);
+        int from = max(vehicles.getPathCursor(row), 1);
+        if (from + 1 < vehicles.getRoutes().length(route))
+            rerouteStarts.push_back(make_pair(vehicles.getRoutes().nodeAt(route, from), row));
+    }
+    stable_sort(rerouteStarts.begin(), rerouteStarts.end(), [](const pair<int, int> &a, const pair<int, int> &b) { return a.first < b.first; });
+
+    vector<int> endNodes;
+    for (int first = 0; first < rerouteStarts.size();)
+    {
+        int startNode = rerouteStarts[first].first;
+        int last = first;
+        endNodes.clear();
+        while (last < rerouteStarts.size() && rerouteStarts[last].first == startNode)
+            endNodes.push_back(vehicles.getDestNode(rerouteStarts[last++].second));
+
+        vector<shared_ptr<const vector<int>>> tails = findRoutes(startNode, endNodes);
+        for (int i = first; i < last; i++)
+        {
+            const vector<int> &tail = *tails[i - first];
+            if (tail.size() < 2)
+                continue;
+
+            // Keep the old route unless the new one is clearly cheaper, so vehicles don't flap between two
+            int row = rerouteStarts[i].second;
+            vector<int> path = vehicles.getPath(row);
+            int from = max(vehicles.getPathCursor(row), 1);
+            if (pathCost(tail, 0) >= (1.0 - REROUTE_GAIN) * pathCost(path, from))
+                continue;
+
+            path.resize(from);
+            path.insert(path.end(), tail.begin(), tail.end());
+            if (vehicles.replaceRoute(row, path))
+                rerouteCount++;
+        }
+        first = last;
+    }
+}
+
+const Graph &SimulationEngine::getMap() const { return cityMap; }
+const SpatialGrid &SimulationEngine::getNodeGrid() const { return nodeGrid; }
+const ReachabilityIndex &SimulationEngine::getReachability() const { return reachability; }
+const DemandSchedule &SimulationEngine::getDemandSchedule() const { return demandSchedule; }
+bool SimulationEngine::hasLiveWeights() const { return liveWeights; }
+const CongestionModel &SimulationEngine::getCongestion() const { return congestion; }
+long long SimulationEngine::getRerouteCount() const { return rerouteCount; }
+
+int SimulationEngine::nearestNode(float x, float y, float maxDistance) const
+{
+    int index = nodeGrid.nearest(sf::Vector2<float>(x, y), maxDistance);
+    return (index == -1) ? -1 : cityMap.idOf(index);
+}
+const VehicleStore &SimulationEngine::getVehicles() const { return vehicles; }
+const vector<TrafficSignal> &SimulationEngine::getSignals() const { return signals; }
+float SimulationEngine::getTotalTime() const { return totalTime; }
+int SimulationEngine::getUndoCount() const { return undoStack.size(); }
+int SimulationEngine::getSignalCount() const { return signals.size(); }
+int SimulationEngine::getArrivedCount() const { return analytics.getCompletedTrips(); }
+
+void SimulationEngine::finalizeAnalytics() { analytics.updateStats(vehicles, signals, totalTime); }
+bool SimulationEngine::saveAnalytics(const string &filename) { return analytics.saveToFile(filename); }
+void SimulationEngine::printAnalytics() const
+{
+    analytics.printSummary();
+    routeCache.printStats();
+    vehicles.getRoutes().printStats();
+    if (liveWeights)
+        cout << "Live weights: " << congestion.getCongestedCount() << " congested roads, " << rerouteCount << " vehicles rerouted" << endl;
+}
+void SimulationEngine::printEmergencyQueue() const { emergencyMgr.printQueue(); }
\ No newline at end of file
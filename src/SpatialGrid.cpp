@@ -0,0 +1,200 @@
+#include "../include/SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+// Target occupancy, and the most cells allowed per node (limits degenerate, very thin maps)
+static const float NODES_PER_CELL = 2.0f;
+static const long long MAX_CELLS_PER_NODE = 4;
+
+SpatialGrid::SpatialGrid() : cellSize(1.0f), columns(0), rows(0) {}
+
+void SpatialGrid::clear()
+{
+    boundsMin = boundsMax = sf::Vector2<float>(0.0f, 0.0f);
+    cellSize = 1.0f;
+    columns = rows = 0;
+    cellStart.clear();
+    cellNodes.clear();
+    cellPositions.clear();
+}
+
+void SpatialGrid::build(const Graph &map)
+{
+    clear();
+
+    int numNodes = map.getNumNodes();
+    if (numNodes == 0)
+        return;
+
+    boundsMin = boundsMax = map.nodeAt(0).position;
+    for (int i = 1; i < numNodes; i++)
+    {
+        sf::Vector2<float> p = map.nodeAt(i).position;
+        boundsMin.x = min(boundsMin.x, p.x);
+        boundsMin.y = min(boundsMin.y, p.y);
+        boundsMax.x = max(boundsMax.x, p.x);
+        boundsMax.y = max(boundsMax.y, p.y);
+    }
+
+    double width = boundsMax.x - boundsMin.x;
+    double height = boundsMax.y - boundsMin.y;
+    double area = max(width * height, 1e-6);
+    double size = sqrt(area * NODES_PER_CELL / numNodes);
+    if (size <= 0.0)
+        size = 1.0;
+
+    // A thin map would get a huge number of tiny cells; grow them until the count is reasonable
+    long long cells;
+    while (true)
+    {
+        long long cols = static_cast<long long>(width / size) + 1;
+        long long rws = static_cast<long long>(height / size) + 1;
+        cells = cols * rws;
+        if (cells <= MAX_CELLS_PER_NODE * numNodes + 16)
+        {
+            columns = static_cast<int>(cols);
+            rows = static_cast<int>(rws);
+            break;
+        }
+        size *= 2.0;
+    }
+    cellSize = static_cast<float>(size);
+
+    // Counting sort of the nodes by cell
+    vector<int> cellOf(numNodes);
+    cellStart.assign(cells + 1, 0);
+    for (int i = 0; i < numNodes; i++)
+    {
+        sf::Vector2<float> p = map.nodeAt(i).position;
+        cellOf[i] = rowOf(p.y) * columns + columnOf(p.x);
+        cellStart[cellOf[i] + 1]++;
+    }
+
+    for (long long c = 0; c < cells; c++)
+        cellStart[c + 1] += cellStart[c];
+
+    cellNodes.resize(numNodes);
+    cellPositions.resize(numNodes);
+    vector<int> next(cellStart.begin(), cellStart.end() - 1);
+    for (int i = 0; i < numNodes; i++)
+    {
+        int slot = next[cellOf[i]]++;
+        cellNodes[slot] = i;
+        cellPositions[slot] = map.nodeAt(i).position;
+    }
+}
+
+int SpatialGrid::columnOf(float x) const
+{
+    int column = static_cast<int>((x - boundsMin.x) / cellSize);
+    return max(0, min(columns - 1, column));
+}
+
+int SpatialGrid::rowOf(float y) const
+{
+    int row = static_cast<int>((y - boundsMin.y) / cellSize);
+    return max(0, min(rows - 1, row));
+}
+
+int SpatialGrid::nearest(sf::Vector2<float> point, float maxDistance) const
+{
+    if (empty() || !(maxDistance >= 0.0f))
+        return -1;
+
+    int centerColumn = columnOf(point.x);
+    int centerRow = rowOf(point.y);
+
+    int best = -1;
+    double bestSquared = static_cast<double>(maxDistance) * maxDistance;
+    int maxRing = max(columns, rows);
+
+    // Search rings of cells outward. A cell in ring r has r - 1 whole cells between it and the
+    // point's cell, so once the best match is closer than that, no further ring can hold a better one.
+    for (int ring = 0; ring <= maxRing; ring++)
+    {
+        double ringDistance = static_cast<double>(ring - 1) * cellSize;
+        if (ring > 1 && ringDistance * ringDistance > bestSquared)
+            break;
+
+        int firstRow = max(0, centerRow - ring), lastRow = min(rows - 1, centerRow + ring);
+        int firstColumn = max(0, centerColumn - ring), lastColumn = min(columns - 1, centerColumn + ring);
+
+        for (int row = firstRow; row <= lastRow; row++)
+        {
+            // Only the ring's border cells; the inside was searched by earlier rings
+            bool edgeRow = (row == centerRow - ring || row == centerRow + ring);
+            int step = edgeRow ? 1 : max(1, 2 * ring);
+
+            for (int column = centerColumn - ring; column <= centerColumn + ring; column += step)
+            {
+                if (column < firstColumn || column > lastColumn)
+                    continue;
+
+                int cell = row * columns + column;
+                for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++)
+                {
+                    double dx = cellPositions[k].x - point.x;
+                    double dy = cellPositions[k].y - point.y;
+                    double squared = dx * dx + dy * dy;
+                    if (squared <= bestSquared && (best == -1 || squared < bestSquared || cellNodes[k] < best))
+                    {
+                        best = cellNodes[k];
+                        bestSquared = squared;
+                    }
+                }
+            }
+        }
+    }
+
+    return best;
+}
+
+void SpatialGrid::queryRange(float left, float top, float right, float bottom, vector<int> &out) const
+{
+    if (empty() || right < boundsMin.x || left > boundsMax.x || bottom < boundsMin.y || top > boundsMax.y)
+        return;
+
+    int firstColumn = columnOf(left), lastColumn = columnOf(right);
+    int firstRow = rowOf(top), lastRow = rowOf(bottom);
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        // A row of cells is one contiguous run of cellNodes
+        int first = cellStart[row * columns + firstColumn];
+        int last = cellStart[row * columns + lastColumn + 1];
+        for (int k = first; k < last; k++)
+        {
+            sf::Vector2<float> p = cellPositions[k];
+            if (p.x >= left && p.x <= right && p.y >= top && p.y <= bottom)
+                out.push_back(cellNodes[k]);
+        }
+    }
+}
+
+void SpatialGrid::queryRadius(sf::Vector2<float> center, float radius, vector<int> &out) const
+{
+    if (empty() || !(radius >= 0.0f))
+        return;
+
+    int firstColumn = columnOf(center.x - radius), lastColumn = columnOf(center.x + radius);
+    int firstRow = rowOf(center.y - radius), lastRow = rowOf(center.y + radius);
+    double limit = static_cast<double>(radius) * radius;
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        int first = cellStart[row * columns + firstColumn];
+        int last = cellStart[row * columns + lastColumn + 1];
+        for (int k = first; k < last; k++)
+        {
+            double dx = cellPositions[k].x - center.x;
+            double dy = cellPositions[k].y - center.y;
+            if (dx * dx + dy * dy <= limit)
+                out.push_back(cellNodes[k]);
+        }
+    }
+}
+
+size_t SpatialGrid::getMemoryBytes() const
+{
+    return cellStart.capacity() * sizeof(int) + cellNodes.capacity() * sizeof(int) + cellPositions.capacity() * sizeof(sf::Vector2<float>);
+}
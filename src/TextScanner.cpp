@@ -0,0 +1,142 @@
+#include "../include/TextScanner.h"
+#include <charconv>
+#include <cstring>
+
+static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v'; }
+
+TextScanner::TextScanner(const char *begin, const char *finish) : cursor(begin), end(finish), lineStart(begin), line(1) {}
+
+void TextScanner::skipWhitespace()
+{
+    while (cursor < end && isSpace(*cursor))
+    {
+        if (*cursor == '\n')
+        {
+            line++;
+            lineStart = cursor + 1;
+        }
+        cursor++;
+    }
+}
+
+const char *TextScanner::tokenEnd() const
+{
+    const char *p = cursor;
+    while (p < end && !isSpace(*p))
+        p++;
+    return p;
+}
+
+bool TextScanner::atEnd()
+{
+    skipWhitespace();
+    return cursor == end;
+}
+
+bool TextScanner::atComment()
+{
+    skipWhitespace();
+    return cursor < end && *cursor == '#';
+}
+
+bool TextScanner::readInt(int &value)
+{
+    skipWhitespace();
+    const char *last = tokenEnd();
+
+    // The number has to be the whole token, so "12abc" is an error rather than 12
+    from_chars_result result = from_chars(cursor, last, value);
+    if (result.ec != errc() || result.ptr != last || cursor == last)
+        return false;
+
+    cursor = last;
+    return true;
+}
+
+bool TextScanner::readDouble(double &value)
+{
+    skipWhitespace();
+    const char *last = tokenEnd();
+
+    from_chars_result result = from_chars(cursor, last, value);
+    if (result.ec != errc() || result.ptr != last || cursor == last)
+        return false;
+
+    cursor = last;
+    return true;
+}
+
+bool TextScanner::readWord(string &word)
+{
+    skipWhitespace();
+    const char *last = tokenEnd();
+    if (cursor == last)
+        return false;
+
+    word.assign(cursor, last);
+    cursor = last;
+    return true;
+}
+
+void TextScanner::skipLine()
+{
+    const void *newline = memchr(cursor, '\n', end - cursor);
+    cursor = newline ? static_cast<const char *>(newline) : end;
+}
+
+int TextScanner::getLine() const
+{
+    // Whitespace before the next token may still hold newlines
+    int result = line;
+    for (const char *p = cursor; p < end && isSpace(*p); p++)
+    {
+        if (*p == '\n')
+            result++;
+    }
+    return result;
+}
+
+int TextScanner::getColumn() const
+{
+    const char *start = lineStart;
+    const char *p = cursor;
+    while (p < end && isSpace(*p))
+    {
+        if (*p == '\n')
+            start = p + 1;
+        p++;
+    }
+    return static_cast<int>(p - start) + 1;
+}
+
+string TextScanner::peekToken() const
+{
+    const char *p = cursor;
+    while (p < end && isSpace(*p))
+        p++;
+    if (p == end)
+        return "end of file";
+
+    const char *last = p;
+    while (last < end && !isSpace(*last) && last - p < 32)
+        last++;
+    return "\"" + string(p, last) + "\"";
+}
+
+long long TextScanner::countLines(const char *begin, const char *finish)
+{
+    long long lines = 0;
+    const char *p = begin;
+    while (p < finish)
+    {
+        const void *newline = memchr(p, '\n', finish - p);
+        if (!newline)
+        {
+            lines++; // Last line without a newline
+            break;
+        }
+        lines++;
+        p = static_cast<const char *>(newline) + 1;
+    }
+    return lines;
+}
@@ -16,13 +16,13 @@ TrafficSignal::TrafficSignal(int id, int nodeID, const sf::Vector2<float> &pos,
     cout << "Traffic Signal " << signalID << " created at intersection " << intersectionID << endl;
 }
 
-void TrafficSignal::toggleLight()
+void TrafficSignal::toggleLight(VehicleStore &vehicles)
 {
     if (state == SignalState::RED)
     {
         state = SignalState::GREEN;
         timer = greenDuration;
-        releaseAllVehicles(); // Release waiting cars
+        releaseAllVehicles(vehicles); // Release waiting cars
         cout << "Signal " << signalID << " switched to GREEN" << endl;
     }
     else if (state == SignalState::GREEN)
@@ -33,7 +33,7 @@ void TrafficSignal::toggleLight()
     }
 }
 
-void TrafficSignal::updateTimer(float deltaTime)
+void TrafficSignal::updateTimer(float deltaTime, VehicleStore &vehicles)
 {
     if (!isAuto)
         return;
@@ -42,11 +42,11 @@ void TrafficSignal::updateTimer(float deltaTime)
 
     if (timer <= 0.0f)
     {
-        switchState();
+        switchState(vehicles);
     }
 }
 
-void TrafficSignal::switchState()
+void TrafficSignal::switchState(VehicleStore &vehicles)
 {
     if (state == SignalState::GREEN)
     {
@@ -58,41 +58,47 @@ void TrafficSignal::switchState()
     {
         state = SignalState::GREEN;
         timer = greenDuration;
-        releaseAllVehicles(); // Release waiting vehicles
+        releaseAllVehicles(vehicles); // Release waiting vehicles
         cout << "Signal " << signalID << " auto-switched to GREEN" << endl;
     }
 }
 
-void TrafficSignal::addVehicleToQueue(Vehicle *car)
+void TrafficSignal::addVehicleToQueue(VehicleHandle car, VehicleStore &vehicles)
 {
-    if (car == nullptr)
+    int row = vehicles.rowOf(car);
+    if (row == -1)
     {
-        cout << "Warning: Attempted to add null vehicle to queue!" << endl;
+        cout << "Warning: Attempted to add a removed vehicle to queue!" << endl;
         return;
     }
 
     waitingQueue.push(car);
-    car->setStatus(VehicleStatus::WAITING);
+    vehicles.setStatus(row, VehicleStatus::WAITING);
 
-    cout << "Vehicle " << car->getID() << " added to queue at Signal " << signalID << " (Queue size: " << waitingQueue.size() << ")" << endl;
+    cout << "Vehicle " << vehicles.getID(row) << " added to queue at Signal " << signalID << " (Queue size: " << waitingQueue.size() << ")" << endl;
 }
 
-Vehicle *TrafficSignal::dequeueVehicle()
+VehicleHandle TrafficSignal::dequeueVehicle(VehicleStore &vehicles)
 {
     if (waitingQueue.empty())
-        return nullptr;
+        return VehicleHandle();
 
-    Vehicle *car = waitingQueue.front();
+    VehicleHandle car = waitingQueue.front();
     waitingQueue.pop();
 
-    car->setStatus(VehicleStatus::MOVING);
+    // The vehicle may have been removed (undone) while it was waiting
+    int row = vehicles.rowOf(car);
+    if (row == -1)
+        return VehicleHandle();
 
-    cout << "Vehicle " << car->getID() << " released from Signal " << signalID << endl;
+    vehicles.setStatus(row, VehicleStatus::MOVING);
+
+    cout << "Vehicle " << vehicles.getID(row) << " released from Signal " << signalID << endl;
 
     return car;
 }
 
-void TrafficSignal::releaseAllVehicles()
+void TrafficSignal::releaseAllVehicles(VehicleStore &vehicles)
 {
     if (state != SignalState::GREEN)
         return;
@@ -100,8 +106,7 @@ void TrafficSignal::releaseAllVehicles()
     int released = 0;
     while (!waitingQueue.empty())
     {
-        Vehicle *car = dequeueVehicle();
-        if (car != nullptr)
+        if (!dequeueVehicle(vehicles).isNull())
             released++;
     }
 
@@ -117,24 +122,18 @@ int TrafficSignal::getIntersectionID() const { return intersectionID; }
 SignalState TrafficSignal::getState() const { return state; }
 sf::Vector2<float> TrafficSignal::getPosition() const { return position; }
 float TrafficSignal::getTimer() const { return timer; }
+float TrafficSignal::getGreenDuration() const { return greenDuration; }
+float TrafficSignal::getRedDuration() const { return redDuration; }
 bool TrafficSignal::isAutoMode() const { return isAuto; }
 
-sf::Color TrafficSignal::getColor() const
-{
-    if (state == SignalState::RED)
-        return sf::Color::Red;
-    else
-        return sf::Color::Green;
-}
-
-void TrafficSignal::setState(SignalState newState)
+void TrafficSignal::setState(SignalState newState, VehicleStore &vehicles)
 {
     state = newState;
 
     if (state == SignalState::GREEN)
     {
         timer = greenDuration;
-        releaseAllVehicles();
+        releaseAllVehicles(vehicles);
     }
     else if (state == SignalState::RED)
         timer = redDuration;
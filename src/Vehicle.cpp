@@ -101,7 +101,10 @@ VehicleStatus Vehicle::getStatus() const { return status; }
 const vector<int> &Vehicle::getPath() const { return path; }
 double Vehicle::getSpeed() const { return speed; }
 sf::Vector2<float> Vehicle::getPosition() const { return position; }
+sf::Vector2<float> Vehicle::getStartPosition() const { return startPosition; }
+sf::Vector2<float> Vehicle::getTargetPosition() const { return targetPosition; }
 float Vehicle::getInterpolation() const { return interpolation; }
+int Vehicle::getCurrentPathIndex() const { return currentPathIndex; }
 int Vehicle::getPriority() const { return priority; }
 bool Vehicle::isEmergency() const { return priority > 0; }
 
@@ -0,0 +1,281 @@
+#include "../include/VehicleStore.h"
+#include <iostream>
+
+VehicleStore::VehicleStore() {}
+
+VehicleHandle VehicleStore::add(const Vehicle &vehicle, float spawnTime)
+{
+    uint32_t row = ids.size();
+
+    statuses.push_back(vehicle.getStatus());
+    speeds.push_back(static_cast<float>(vehicle.getSpeed()));
+    interpolations.push_back(vehicle.getInterpolation());
+    positions.push_back(vehicle.getPosition());
+    startPositions.push_back(vehicle.getStartPosition());
+    targetPositions.push_back(vehicle.getTargetPosition());
+
+    ids.push_back(vehicle.getID());
+    priorities.push_back(vehicle.getPriority());
+    pathCursors.push_back(vehicle.getCurrentPathIndex());
+    spawnTimes.push_back(spawnTime);
+    expectedArrivals.push_back(-1.0f);
+    routeIDs.push_back(routes.intern(vehicle.getPath()));
+
+    return assignSlot(row);
+}
+
+VehicleHandle VehicleStore::add(int id, const vector<int> &path, float speed, int priority, const sf::Vector2<float> &startPosition, const sf::Vector2<float> &targetPosition, float spawnTime)
+{
+    uint32_t row = ids.size();
+
+    // Same starting state as a freshly constructed Vehicle
+    VehicleStatus status = (priority > 0) ? VehicleStatus::EMERGENCY : VehicleStatus::MOVING;
+    if (path.empty())
+    {
+        cout << "Warning: Vehicle " << id << " created with empty path!" << endl;
+        status = VehicleStatus::ARRIVED;
+    }
+
+    statuses.push_back(status);
+    speeds.push_back(speed);
+    interpolations.push_back(0.0f);
+    positions.push_back(startPosition);
+    startPositions.push_back(startPosition);
+    targetPositions.push_back(targetPosition);
+
+    ids.push_back(id);
+    priorities.push_back(priority);
+    pathCursors.push_back(0);
+    spawnTimes.push_back(spawnTime);
+    expectedArrivals.push_back(-1.0f);
+    routeIDs.push_back(routes.intern(path));
+
+    return assignSlot(row);
+}
+
+VehicleHandle VehicleStore::assignSlot(uint32_t row)
+{
+    // Reuse a freed slot if there is one (its generation was already bumped on removal)
+    uint32_t slot;
+    if (!freeSlots.empty())
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        slotRows[slot] = row;
+    }
+    else
+    {
+        slot = slotRows.size();
+        slotRows.push_back(row);
+        slotGenerations.push_back(0);
+    }
+    rowSlots.push_back(slot);
+
+    return VehicleHandle(slot, slotGenerations[slot]);
+}
+
+bool VehicleStore::remove(VehicleHandle handle)
+{
+    int row = rowOf(handle);
+    if (row == -1)
+        return false;
+
+    int last = size() - 1;
+    routes.release(routeIDs[row]);
+
+    if (row != last)
+    {
+        statuses[row] = statuses[last];
+        speeds[row] = speeds[last];
+        interpolations[row] = interpolations[last];
+        positions[row] = positions[last];
+        startPositions[row] = startPositions[last];
+        targetPositions[row] = targetPositions[last];
+
+        ids[row] = ids[last];
+        priorities[row] = priorities[last];
+        pathCursors[row] = pathCursors[last];
+        spawnTimes[row] = spawnTimes[last];
+        expectedArrivals[row] = expectedArrivals[last];
+        routeIDs[row] = routeIDs[last];
+
+        // The moved vehicle keeps its slot; only the slot's row changes
+        rowSlots[row] = rowSlots[last];
+        slotRows[rowSlots[row]] = row;
+    }
+
+    statuses.pop_back();
+    speeds.pop_back();
+    interpolations.pop_back();
+    positions.pop_back();
+    startPositions.pop_back();
+    targetPositions.pop_back();
+
+    ids.pop_back();
+    priorities.pop_back();
+    pathCursors.pop_back();
+    spawnTimes.pop_back();
+    expectedArrivals.pop_back();
+    routeIDs.pop_back();
+    rowSlots.pop_back();
+
+    slotGenerations[handle.index]++;
+    freeSlots.push_back(handle.index);
+    return true;
+}
+
+int VehicleStore::rowOf(VehicleHandle handle) const
+{
+    if (handle.index >= slotGenerations.size() || slotGenerations[handle.index] != handle.generation)
+        return -1;
+
+    return slotRows[handle.index];
+}
+
+bool VehicleStore::isValid(VehicleHandle handle) const { return rowOf(handle) != -1; }
+
+VehicleHandle VehicleStore::handleAt(int row) const
+{
+    uint32_t slot = rowSlots[row];
+    return VehicleHandle(slot, slotGenerations[slot]);
+}
+
+int VehicleStore::size() const { return ids.size(); }
+bool VehicleStore::empty() const { return ids.empty(); }
+
+void VehicleStore::reserve(int capacity)
+{
+    statuses.reserve(capacity);
+    speeds.reserve(capacity);
+    interpolations.reserve(capacity);
+    positions.reserve(capacity);
+    startPositions.reserve(capacity);
+    targetPositions.reserve(capacity);
+
+    ids.reserve(capacity);
+    priorities.reserve(capacity);
+    pathCursors.reserve(capacity);
+    spawnTimes.reserve(capacity);
+    expectedArrivals.reserve(capacity);
+    routeIDs.reserve(capacity);
+    rowSlots.reserve(capacity);
+}
+
+void VehicleStore::clear()
+{
+    statuses.clear();
+    speeds.clear();
+    interpolations.clear();
+    positions.clear();
+    startPositions.clear();
+    targetPositions.clear();
+
+    ids.clear();
+    priorities.clear();
+    pathCursors.clear();
+    spawnTimes.clear();
+    expectedArrivals.clear();
+    routeIDs.clear();
+    routes.clear();
+
+    // Bump every live slot so handles from before the clear don't resolve to new vehicles
+    for (uint32_t slot : rowSlots)
+    {
+        slotGenerations[slot]++;
+        freeSlots.push_back(slot);
+    }
+    rowSlots.clear();
+}
+
+void VehicleStore::updatePositions(float deltaTime, vector<int> &reached)
+{
+    int count = statuses.size();
+
+    for (int row = 0; row < count; row++)
+    {
+        VehicleStatus status = statuses[row];
+        if (status != VehicleStatus::MOVING && status != VehicleStatus::EMERGENCY)
+            continue;
+
+        // Same linear interpolation as Vehicle::updateVisualPosition, column by column
+        float t = interpolations[row] + speeds[row] * deltaTime * 0.5f;
+        if (t > 1.0f)
+            t = 1.0f;
+        interpolations[row] = t;
+
+        positions[row].x = startPositions[row].x * (1.0f - t) + targetPositions[row].x * t;
+        positions[row].y = startPositions[row].y * (1.0f - t) + targetPositions[row].y * t;
+
+        if (t >= 1.0f)
+            reached.push_back(row);
+    }
+}
+
+void VehicleStore::moveToNextNode(int row, const sf::Vector2<float> &nextNodePos)
+{
+    int route = routeIDs[row];
+
+    if (route == -1 || pathCursors[row] >= routes.length(route) - 1 || (statuses[row] != VehicleStatus::MOVING && statuses[row] != VehicleStatus::EMERGENCY))
+        return;
+
+    pathCursors[row]++;
+
+    startPositions[row] = positions[row];
+    targetPositions[row] = nextNodePos;
+    interpolations[row] = 0.0f;
+
+    cout << "Vehicle " << ids[row] << " has moved to Node " << routes.nodeAt(route, pathCursors[row]) << endl;
+}
+
+void VehicleStore::setStatus(int row, VehicleStatus newStatus) { statuses[row] = newStatus; }
+void VehicleStore::setTargetPosition(int row, const sf::Vector2<float> &target)
+{
+    targetPositions[row] = target;
+    interpolations[row] = 0.0f;
+}
+
+void VehicleStore::setExpectedArrival(int row, float time) { expectedArrivals[row] = time; }
+
+bool VehicleStore::replaceRoute(int row, const vector<int> &path)
+{
+    int route = routeIDs[row];
+    if (route == -1 || static_cast<int>(path.size()) <= pathCursors[row])
+        return false;
+    for (int i = 0; i <= pathCursors[row]; i++)
+    {
+        if (path[i] != routes.nodeAt(route, i))
+            return false;
+    }
+
+    // Intern first, so an identical path never drops to zero holders in between
+    routeIDs[row] = routes.intern(path);
+    routes.release(route);
+    return true;
+}
+
+int VehicleStore::getID(int row) const { return ids[row]; }
+VehicleStatus VehicleStore::getStatus(int row) const { return statuses[row]; }
+int VehicleStore::getCurrentNode(int row) const { return routeIDs[row] == -1 ? -1 : routes.nodeAt(routeIDs[row], pathCursors[row]); }
+int VehicleStore::getNextNode(int row) const
+{
+    int route = routeIDs[row];
+    return (route != -1 && pathCursors[row] < routes.length(route) - 1) ? routes.nodeAt(route, pathCursors[row] + 1) : -1;
+}
+int VehicleStore::getOriginNode(int row) const { return routeIDs[row] == -1 ? -1 : routes.front(routeIDs[row]); }
+int VehicleStore::getDestNode(int row) const { return routeIDs[row] == -1 ? -1 : routes.back(routeIDs[row]); }
+int VehicleStore::getRouteID(int row) const { return routeIDs[row]; }
+int VehicleStore::getPathCursor(int row) const { return pathCursors[row]; }
+vector<int> VehicleStore::getPath(int row) const { return routes.getPath(routeIDs[row]); }
+float VehicleStore::getSpeed(int row) const { return speeds[row]; }
+sf::Vector2<float> VehicleStore::getPosition(int row) const { return positions[row]; }
+float VehicleStore::getInterpolation(int row) const { return interpolations[row]; }
+float VehicleStore::getSpawnTime(int row) const { return spawnTimes[row]; }
+float VehicleStore::getExpectedArrival(int row) const { return expectedArrivals[row]; }
+int VehicleStore::getPriority(int row) const { return priorities[row]; }
+bool VehicleStore::isEmergency(int row) const { return priorities[row] > 0; }
+bool VehicleStore::hasArrivedDest(int row) const { return statuses[row] == VehicleStatus::ARRIVED; }
+
+const vector<VehicleStatus> &VehicleStore::getStatuses() const { return statuses; }
+const vector<int> &VehicleStore::getPriorities() const { return priorities; }
+const vector<sf::Vector2<float>> &VehicleStore::getPositions() const { return positions; }
+const RoutePool &VehicleStore::getRoutes() const { return routes; }
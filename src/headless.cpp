@@ -0,0 +1,228 @@
+#include "../include/SimulationEngine.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+using namespace std;
+
+// Headless runner: steps the engine as fast as possible without opening a window.
+// Usage: TrafficHeadless --map <file> --duration <sec> --seed <n> --output <file>
+//                        [--tick <sec>] [--spawn-rate <veh/s>] [--emergency-rate <veh/s>]
+//                        [--router astar|dijkstra|bidirectional|ch|table] [--ch-cache <file>] [--table-cache <file>]
+//                        [--route-cache <routes>] [--demand <file>] [--live-weights <sec>] [--reroutes <per tick>]
+//                        [--signal-aware] [--no-demo-trips] [--verbose]
+
+static void printUsage()
+{
+    cerr << "Usage: TrafficHeadless --map <file> --duration <seconds> --seed <n> --output <file>" << endl;
+    cerr << "       [--tick <seconds>] [--spawn-rate <vehicles/s>] [--emergency-rate <vehicles/s>]" << endl;
+    cerr << "       [--router astar|dijkstra|bidirectional|ch|table] [--ch-cache <file>] [--table-cache <file>]" << endl;
+    cerr << "       [--route-cache <routes>] [--demand <file>] [--live-weights <seconds>] [--reroutes <per tick>]" << endl;
+    cerr << "       [--signal-aware] [--no-demo-trips] [--verbose]" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    string mapFile = "data/roads.txt";
+    string outputFile = "data/headless_log.txt";
+    double duration = 60.0;
+    unsigned int seed = 1;
+    float tickSize = 1.0f / 60.0f;
+    double spawnRate = 0.0;
+    double emergencyRate = 0.0;
+    RouteAlgorithm router = RouteAlgorithm::ASTAR;
+    RouteSource source = RouteSource::SEARCH;
+    string hierarchyCache;
+    string tableCache;
+    string demandFile;
+    float weightInterval = 0.0f; // 0 keeps the map's weights fixed
+    int reroutesPerTick = 64;
+    int routeCacheSize = 4096;
+    bool signalAware = false;
+    bool demoTrips = true;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--map" && hasValue)
+            mapFile = argv[++i];
+        else if (arg == "--duration" && hasValue)
+            duration = atof(argv[++i]);
+        else if (arg == "--seed" && hasValue)
+            seed = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--output" && hasValue)
+            outputFile = argv[++i];
+        else if (arg == "--tick" && hasValue)
+            tickSize = static_cast<float>(atof(argv[++i]));
+        else if (arg == "--spawn-rate" && hasValue)
+            spawnRate = atof(argv[++i]);
+        else if (arg == "--emergency-rate" && hasValue)
+            emergencyRate = atof(argv[++i]);
+        else if (arg == "--router" && hasValue)
+        {
+            string name = argv[++i];
+            if (name == "astar")
+                router = RouteAlgorithm::ASTAR;
+            else if (name == "dijkstra")
+                router = RouteAlgorithm::DIJKSTRA;
+            else if (name == "bidirectional")
+                router = RouteAlgorithm::BIDIRECTIONAL;
+            else if (name == "ch")
+                source = RouteSource::HIERARCHY;
+            else if (name == "table")
+                source = RouteSource::NEXT_HOP_TABLE;
+            else
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        else if (arg == "--ch-cache" && hasValue)
+            hierarchyCache = argv[++i];
+        else if (arg == "--table-cache" && hasValue)
+            tableCache = argv[++i];
+        else if (arg == "--route-cache" && hasValue)
+            routeCacheSize = atoi(argv[++i]);
+        else if (arg == "--demand" && hasValue)
+            demandFile = argv[++i];
+        else if (arg == "--live-weights" && hasValue)
+            weightInterval = static_cast<float>(atof(argv[++i]));
+        else if (arg == "--reroutes" && hasValue)
+            reroutesPerTick = atoi(argv[++i]);
+        else if (arg == "--signal-aware")
+            signalAware = true;
+        else if (arg == "--no-demo-trips")
+            demoTrips = false;
+        else if (arg == "--verbose")
+            verbose = true;
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (duration <= 0.0 || tickSize <= 0.0f)
+    {
+        cerr << "Duration and tick must be positive" << endl;
+        return 1;
+    }
+
+    // Per-event logging dominates run time at high speed, so it is muted unless asked for.
+    // Setup output is kept aside instead, so loader errors still reach the user on failure
+    streambuf *coutBuffer = cout.rdbuf();
+    ostringstream setupLog;
+    if (!verbose)
+        cout.rdbuf(setupLog.rdbuf());
+
+    SimulationEngine engine(seed, tickSize);
+    engine.setRouteAlgorithm(router);
+    engine.setRouteCacheCapacity(routeCacheSize);
+    engine.setSignalAwareRouting(signalAware);
+    if (!engine.loadMap(mapFile))
+    {
+        cout.rdbuf(coutBuffer);
+        cerr << setupLog.str();
+        cerr << "Failed to load map file: " << mapFile << endl;
+        return 1;
+    }
+
+    if (source == RouteSource::NEXT_HOP_TABLE && !engine.enableNextHopTable(tableCache))
+    {
+        cout.rdbuf(coutBuffer);
+        cerr << setupLog.str();
+        cerr << "Failed to prepare the next-hop table" << endl;
+        return 1;
+    }
+
+    if (source == RouteSource::HIERARCHY && !engine.enableHierarchy(hierarchyCache))
+    {
+        cout.rdbuf(coutBuffer);
+        cerr << setupLog.str();
+        cerr << "Failed to prepare the contraction hierarchy" << endl;
+        return 1;
+    }
+
+    if (weightInterval > 0.0f)
+        engine.enableLiveWeights(weightInterval, reroutesPerTick);
+
+    if (weightInterval > 0.0f && source != RouteSource::SEARCH)
+        cerr << "Warning: --live-weights only changes graph search routes; with --router ch or table vehicles keep the precomputed routes and are never rerouted" << endl;
+
+    engine.initializeSignals();
+    if (demoTrips)
+        engine.spawnInitialVehicles();
+
+    if (!demandFile.empty() && !engine.loadDemand(demandFile))
+    {
+        cout.rdbuf(coutBuffer);
+        cerr << setupLog.str();
+        cerr << "Failed to load demand file: " << demandFile << endl;
+        return 1;
+    }
+
+    if (!verbose)
+        cout.rdbuf(nullptr);
+
+    double regularDue = 0.0;
+    double emergencyDue = 0.0;
+    long long ticks = static_cast<long long>(duration / tickSize + 0.5);
+
+    auto wallStart = chrono::steady_clock::now();
+
+    for (long long t = 0; t < ticks; t++)
+    {
+        // Fractional spawn credit so rates below one vehicle per tick still work
+        regularDue += spawnRate * tickSize;
+        while (regularDue >= 1.0)
+        {
+            engine.spawnRegularVehicle();
+            regularDue -= 1.0;
+        }
+
+        emergencyDue += emergencyRate * tickSize;
+        while (emergencyDue >= 1.0)
+        {
+            engine.spawnEmergencyVehicle();
+            emergencyDue -= 1.0;
+        }
+
+        engine.step();
+    }
+
+    double wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+
+    engine.finalizeAnalytics();
+    bool saved = engine.saveAnalytics(outputFile);
+
+    cout.rdbuf(coutBuffer);
+
+    double simSeconds = engine.getTotalTime();
+    cout << "\n=== HEADLESS RUN ===" << endl;
+    cout << "Map:                 " << mapFile << endl;
+    cout << "Seed:                " << seed << endl;
+    cout << "Ticks:               " << ticks << " (tick = " << tickSize << "s)" << endl;
+    cout << fixed << setprecision(2);
+    cout << "Simulated time:      " << simSeconds << " s" << endl;
+    cout << "Wall time:           " << setprecision(4) << wallSeconds << " s" << endl;
+    if (wallSeconds > 0.0)
+    {
+        cout << "Throughput:          " << setprecision(1) << simSeconds / wallSeconds << " sim-s/wall-s" << endl;
+        cout << "Tick rate:           " << setprecision(0) << ticks / wallSeconds << " ticks/s" << endl;
+    }
+    if (!demandFile.empty())
+        cout << "Demand trips:        " << engine.getDemandSchedule().getGeneratedCount() << " generated from " << engine.getDemandSchedule().getNumFlows() << " flows" << endl;
+    if (engine.hasLiveWeights())
+        cout << "Reroutes:            " << engine.getRerouteCount() << " (" << engine.getCongestion().getCongestedCount() << " congested roads at the end)" << endl;
+    cout << "Report:              " << (saved ? outputFile : "not written") << endl;
+    cout << "====================" << endl;
+
+    engine.printAnalytics();
+
+    return saved ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+#include "../include/Graph.h"
+#include "../include/ContractionHierarchy.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+using namespace std;
+
+// Offline preprocessing: builds the contraction hierarchy for a map and writes it next to the map,
+// so simulator runs can load it instead of contracting at startup.
+// Usage: BuildCH --map <file> --output <file> [--threads <n>]
+
+int main(int argc, char *argv[])
+{
+    string mapFile = "data/roads.txt";
+    string outputFile = "data/roads.ch";
+    int threads = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--map" && hasValue)
+            mapFile = argv[++i];
+        else if (arg == "--output" && hasValue)
+            outputFile = argv[++i];
+        else if (arg == "--threads" && hasValue)
+            threads = atoi(argv[++i]);
+        else
+        {
+            cerr << "Usage: BuildCH --map <file> --output <file> [--threads <n>]" << endl;
+            return 1;
+        }
+    }
+
+    Graph cityMap;
+    if (!cityMap.loadFromFile(mapFile))
+        return 1;
+
+    ContractionHierarchy hierarchy;
+    auto start = chrono::steady_clock::now();
+    if (!hierarchy.build(cityMap, threads))
+        return 1;
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "Preprocessing took " << fixed << setprecision(2) << seconds << "s" << endl;
+    return hierarchy.saveToFile(outputFile) ? 0 : 1;
+}
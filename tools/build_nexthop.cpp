@@ -0,0 +1,50 @@
+#include "../include/Graph.h"
+#include "../include/NextHopTable.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+using namespace std;
+
+// Offline preprocessing: builds the all-pairs next-hop table for a map and writes it next to the
+// map, so simulator runs can memory-map it instead of running one search per node at startup.
+// Usage: BuildNextHop --map <file> --output <file> [--threads <n>]
+
+int main(int argc, char *argv[])
+{
+    string mapFile = "data/roads.txt";
+    string outputFile = "data/roads.nh";
+    int threads = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--map" && hasValue)
+            mapFile = argv[++i];
+        else if (arg == "--output" && hasValue)
+            outputFile = argv[++i];
+        else if (arg == "--threads" && hasValue)
+            threads = atoi(argv[++i]);
+        else
+        {
+            cerr << "Usage: BuildNextHop --map <file> --output <file> [--threads <n>]" << endl;
+            return 1;
+        }
+    }
+
+    Graph cityMap;
+    if (!cityMap.loadFromFile(mapFile))
+        return 1;
+
+    NextHopTable table;
+    auto start = chrono::steady_clock::now();
+    if (!table.build(cityMap, threads))
+        return 1;
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "Preprocessing took " << fixed << setprecision(2) << seconds << "s" << endl;
+    return table.saveToFile(outputFile) ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+#include "../include/Graph.h"
+#include "../include/MappedFile.h"
+#include "../include/TextScanner.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+using namespace std;
+
+// Converts a text map to the binary format, which the simulator memory-maps instead of parsing.
+// An optional signal file (one "node green red auto|manual" per line) is stored with the map.
+// Usage: ConvertMap --map <file> --output <file> [--signals <file>]
+
+static bool loadSignals(const string &fileName, const Graph &cityMap, vector<SignalPlacement> &placements)
+{
+    MappedFile file;
+    if (!file.open(fileName))
+        return false;
+
+    TextScanner scanner(file.getData(), file.getData() + file.size());
+    while (!scanner.atEnd())
+    {
+        SignalPlacement placement;
+        double green, red;
+        string mode;
+        if (!scanner.readInt(placement.node) || !scanner.readDouble(green) || !scanner.readDouble(red) ||
+            !scanner.readWord(mode) || (mode != "auto" && mode != "manual"))
+        {
+            cout << "Error: " << fileName << ":" << scanner.getLine() << ":" << scanner.getColumn() << ": expected \"node green red auto|manual\", found " << scanner.peekToken() << endl;
+            return false;
+        }
+
+        if (!cityMap.nodeExists(placement.node))
+        {
+            cout << "Error: " << fileName << ": signal at node " << placement.node << ", which is not in the map" << endl;
+            return false;
+        }
+
+        placement.greenDuration = static_cast<float>(green);
+        placement.redDuration = static_cast<float>(red);
+        placement.automatic = (mode == "auto") ? 1 : 0;
+        placements.push_back(placement);
+    }
+
+    cout << "Loaded " << placements.size() << " signal placements from " << fileName << endl;
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    string mapFile = "data/roads.txt";
+    string outputFile = "data/roads.tsmap";
+    string signalFile;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--map" && hasValue)
+            mapFile = argv[++i];
+        else if (arg == "--output" && hasValue)
+            outputFile = argv[++i];
+        else if (arg == "--signals" && hasValue)
+            signalFile = argv[++i];
+        else
+        {
+            cerr << "Usage: ConvertMap --map <file> --output <file> [--signals <file>]" << endl;
+            return 1;
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    Graph cityMap;
+    if (!cityMap.loadFromFile(mapFile))
+        return 1;
+    double parseSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if (!signalFile.empty())
+    {
+        vector<SignalPlacement> placements;
+        if (!loadSignals(signalFile, cityMap, placements))
+            return 1;
+        cityMap.setSignalPlacements(placements);
+    }
+
+    if (!cityMap.saveBinary(outputFile))
+        return 1;
+
+    // Map it back as the simulator would, checksum included
+    start = chrono::steady_clock::now();
+    Graph check;
+    if (!check.loadBinary(outputFile) || check.getNumNodes() != cityMap.getNumNodes() || check.getNumEdges() != cityMap.getNumEdges())
+    {
+        cout << "Error: " << outputFile << " did not read back correctly" << endl;
+        return 1;
+    }
+    double mapSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << fixed << setprecision(1) << "Text load: " << parseSeconds * 1000.0 << " ms, binary load (with checksum): " << mapSeconds * 1000.0 << " ms" << endl;
+    return 0;
+}
@@ -0,0 +1,607 @@
+#include "../include/Graph.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+using namespace std;
+
+// Imports a local OpenStreetMap XML extract (.osm) as a simulator map. The file is streamed twice,
+// so memory grows with the road network, not with the extract:
+//   pass 1 reads only the drivable ways and counts how often each node is referenced;
+//   pass 2 keeps coordinates for referenced nodes only, then splits every way at intersections.
+// Nodes used by a single way are shape points: they are folded into the road's length (and the
+// optional geometry file) instead of becoming graph nodes. Weights are travel times in seconds,
+// from the geodesic length and the maxspeed tag (or a default per road class). Node positions are
+// metres on a local equirectangular projection, y pointing south like the screen.
+// Usage: OsmImport --osm <file> [--output <text map>] [--binary <binary map>] [--geometry <file>]
+
+static const double EARTH_RADIUS = 6371008.8; // Mean radius, metres
+static const double DEGREES_TO_RADIANS = 3.14159265358979323846 / 180.0;
+static const size_t READ_CHUNK = 1 << 20;
+static const int32_t NO_COORDINATE = INT32_MIN;
+
+// ---------- Streaming tag reader ----------
+
+// Hands out one XML tag ("<...>", without the brackets) at a time from a file read in chunks.
+// Text between tags, comments and the XML declaration are skipped.
+class OsmReader
+{
+    ifstream file;
+    vector<char> buffer;
+    size_t begin;
+    size_t end;
+    long long bytesRead;
+
+    bool refill()
+    {
+        // Keep the unread tail and append the next chunk; grow if a single tag is larger than the buffer
+        memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+        if (buffer.size() - end < READ_CHUNK)
+            buffer.resize(end + READ_CHUNK);
+
+        file.read(buffer.data() + end, buffer.size() - end);
+        size_t got = static_cast<size_t>(file.gcount());
+        end += got;
+        bytesRead += got;
+        return got > 0;
+    }
+
+public:
+    OsmReader() : buffer(READ_CHUNK), begin(0), end(0), bytesRead(0) {}
+
+    bool open(const string &fileName)
+    {
+        file.open(fileName, ios::binary);
+        if (!file.is_open())
+        {
+            cout << "Error in opening file " << fileName << endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool nextTag(string_view &tag)
+    {
+        while (true)
+        {
+            const char *data = buffer.data();
+            const void *open = memchr(data + begin, '<', end - begin);
+            if (!open)
+            {
+                begin = end;
+                if (!refill())
+                    return false;
+                continue;
+            }
+
+            size_t start = static_cast<const char *>(open) - data;
+            const void *close = memchr(data + start, '>', end - start);
+            if (!close)
+            {
+                begin = start;
+                if (!refill())
+                    return false;
+                continue;
+            }
+
+            size_t finish = static_cast<const char *>(close) - data;
+            begin = finish + 1;
+            if (data[start + 1] == '?' || data[start + 1] == '!')
+                continue;
+
+            tag = string_view(data + start + 1, finish - start - 1);
+            return true;
+        }
+    }
+
+    long long getBytesRead() const { return bytesRead; }
+};
+
+static bool tagIs(string_view tag, string_view name)
+{
+    return tag.size() >= name.size() && tag.compare(0, name.size(), name) == 0 &&
+           (tag.size() == name.size() || tag[name.size()] == ' ' || tag[name.size()] == '/' || tag[name.size()] == '\t' || tag[name.size()] == '\n' || tag[name.size()] == '\r');
+}
+
+static bool selfClosing(string_view tag) { return !tag.empty() && tag.back() == '/'; }
+
+// Value of attribute 'name' (quoted with ' or "); entities are left as they are
+static bool attribute(string_view tag, string_view name, string_view &value)
+{
+    size_t at = 0;
+    while ((at = tag.find(name, at)) != string_view::npos)
+    {
+        size_t equals = at + name.size();
+        bool startsWord = (at > 0 && (tag[at - 1] == ' ' || tag[at - 1] == '\t' || tag[at - 1] == '\n' || tag[at - 1] == '\r'));
+        if (startsWord && equals + 1 < tag.size() && tag[equals] == '=' && (tag[equals + 1] == '"' || tag[equals + 1] == '\''))
+        {
+            char quote = tag[equals + 1];
+            size_t close = tag.find(quote, equals + 2);
+            if (close == string_view::npos)
+                return false;
+            value = tag.substr(equals + 2, close - equals - 2);
+            return true;
+        }
+        at = equals;
+    }
+    return false;
+}
+
+static bool attributeInt(string_view tag, string_view name, long long &value)
+{
+    string_view text;
+    return attribute(tag, name, text) && from_chars(text.data(), text.data() + text.size(), value).ec == errc();
+}
+
+static bool attributeDouble(string_view tag, string_view name, double &value)
+{
+    string_view text;
+    return attribute(tag, name, text) && from_chars(text.data(), text.data() + text.size(), value).ec == errc();
+}
+
+// ---------- Way classification ----------
+
+// The tags of one way that matter for routing
+struct WayTags
+{
+    string highway;
+    string oneway;
+    string maxspeed;
+    string junction;
+    string access;
+    string area;
+
+    void clear() { highway.clear(), oneway.clear(), maxspeed.clear(), junction.clear(), access.clear(), area.clear(); }
+
+    void set(string_view key, string_view value)
+    {
+        if (key == "highway")
+            highway = value;
+        else if (key == "oneway")
+            oneway = value;
+        else if (key == "maxspeed")
+            maxspeed = value;
+        else if (key == "junction")
+            junction = value;
+        else if (key == "access" || key == "motor_vehicle")
+            access = value;
+        else if (key == "area")
+            area = value;
+    }
+};
+
+// Default speed (km/h) for drivable road classes, 0 for everything else
+static double defaultSpeed(const string &highway)
+{
+    static const pair<const char *, double> speeds[] = {
+        {"motorway", 110}, {"trunk", 90}, {"primary", 70}, {"secondary", 60}, {"tertiary", 50},
+        {"unclassified", 40}, {"residential", 30}, {"living_street", 10}, {"service", 20}, {"road", 40},
+        {"motorway_link", 60}, {"trunk_link", 50}, {"primary_link", 50}, {"secondary_link", 40}, {"tertiary_link", 30}};
+
+    for (const auto &entry : speeds)
+    {
+        if (highway == entry.first)
+            return entry.second;
+    }
+    return 0.0;
+}
+
+static bool isDrivable(const WayTags &tags)
+{
+    return defaultSpeed(tags.highway) > 0.0 && tags.area != "yes" && tags.access != "no" && tags.access != "private";
+}
+
+static double speedOf(const WayTags &tags)
+{
+    double speed = 0.0;
+    const string &text = tags.maxspeed;
+    if (text == "walk")
+        speed = 5.0;
+    else if (from_chars(text.data(), text.data() + text.size(), speed).ec == errc() && text.find("mph") != string::npos)
+        speed *= 1.609344;
+
+    return (speed > 0.0) ? speed : defaultSpeed(tags.highway);
+}
+
+// +1 one-way along the node order, -1 against it, 0 both ways
+static int directionOf(const WayTags &tags)
+{
+    if (tags.oneway == "yes" || tags.oneway == "true" || tags.oneway == "1")
+        return 1;
+    if (tags.oneway == "-1" || tags.oneway == "reverse")
+        return -1;
+    if (tags.oneway == "no" || tags.oneway == "false" || tags.oneway == "0")
+        return 0;
+    return (tags.highway == "motorway" || tags.junction == "roundabout") ? 1 : 0;
+}
+
+// ---------- Import state ----------
+
+// A road between two graph nodes, after folding in its shape points
+struct ImportedRoad
+{
+    int from;
+    int to;
+    double seconds;
+    bool oneWay;
+};
+
+struct Importer
+{
+    // Every node referenced by a drivable way, sorted, with a saturating reference count
+    // (way endpoints count twice, so they always become graph nodes)
+    vector<long long> referenced;
+    vector<uint8_t> references;
+    vector<int32_t> latitudes; // 1e-7 degrees, NO_COORDINATE until pass 2 sees the node
+    vector<int32_t> longitudes;
+    vector<int> graphIndex; // -1 for shape points
+
+    int graphNodes = 0;
+    vector<ImportedRoad> roads;
+    long long ways = 0;
+    long long drivableWays = 0;
+    long long shapePoints = 0;
+    long long missingPoints = 0; // Way nodes the extract lacks; ways are cut there
+
+    // Projection, fixed when pass 2 reaches the first way
+    bool projected = false;
+    double originLatitude = 0.0, originLongitude = 0.0, maxLatitude = 0.0;
+    double metresPerDegreeLongitude = 0.0;
+
+    FILE *geometry = nullptr;
+
+    int find(long long id) const
+    {
+        auto it = lower_bound(referenced.begin(), referenced.end(), id);
+        return (it != referenced.end() && *it == id) ? static_cast<int>(it - referenced.begin()) : -1;
+    }
+
+    void project(int ref, double &x, double &y) const
+    {
+        x = (longitudes[ref] * 1e-7 - originLongitude) * metresPerDegreeLongitude;
+        y = (maxLatitude - latitudes[ref] * 1e-7) * EARTH_RADIUS * DEGREES_TO_RADIANS;
+    }
+
+    void fixProjection()
+    {
+        double minLat = 90, maxLat = -90, minLon = 180;
+        for (size_t i = 0; i < referenced.size(); i++)
+        {
+            if (latitudes[i] == NO_COORDINATE)
+                continue;
+            minLat = min(minLat, latitudes[i] * 1e-7);
+            maxLat = max(maxLat, latitudes[i] * 1e-7);
+            minLon = min(minLon, longitudes[i] * 1e-7);
+        }
+
+        originLongitude = minLon;
+        maxLatitude = maxLat;
+        originLatitude = (minLat + maxLat) / 2.0;
+        metresPerDegreeLongitude = EARTH_RADIUS * DEGREES_TO_RADIANS * cos(originLatitude * DEGREES_TO_RADIANS);
+        projected = true;
+    }
+};
+
+static double geodesicLength(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2)
+{
+    // Haversine
+    double phi1 = lat1 * 1e-7 * DEGREES_TO_RADIANS, phi2 = lat2 * 1e-7 * DEGREES_TO_RADIANS;
+    double dPhi = phi2 - phi1;
+    double dLambda = (lon2 - lon1) * 1e-7 * DEGREES_TO_RADIANS;
+    double h = sin(dPhi / 2) * sin(dPhi / 2) + cos(phi1) * cos(phi2) * sin(dLambda / 2) * sin(dLambda / 2);
+    return 2.0 * EARTH_RADIUS * asin(min(1.0, sqrt(h)));
+}
+
+// Streams the whole file: 'onNode(tag)' for every node element, 'onWay(refs, tags)' for every
+// drivable way once its closing tag is reached
+template <typename NodeCallback, typename WayCallback>
+static void scanFile(OsmReader &reader, long long &ways, NodeCallback onNode, WayCallback onWay)
+{
+    vector<long long> refs;
+    WayTags tags;
+    bool inWay = false;
+
+    string_view tag;
+    while (reader.nextTag(tag))
+    {
+        if (inWay)
+        {
+            long long ref;
+            string_view key, value;
+            if (tagIs(tag, "nd") && attributeInt(tag, "ref", ref))
+                refs.push_back(ref);
+            else if (tagIs(tag, "tag") && attribute(tag, "k", key) && attribute(tag, "v", value))
+                tags.set(key, value);
+            else if (tagIs(tag, "/way"))
+            {
+                inWay = false;
+                ways++;
+                if (refs.size() >= 2 && isDrivable(tags))
+                    onWay(refs, tags);
+            }
+        }
+        else if (tagIs(tag, "node"))
+            onNode(tag);
+        else if (tagIs(tag, "way") && !selfClosing(tag))
+        {
+            inWay = true;
+            refs.clear();
+            tags.clear();
+        }
+    }
+}
+
+// Pass 1: which nodes do drivable ways use, and how often
+static bool countReferences(const string &fileName, Importer &state)
+{
+    OsmReader reader;
+    if (!reader.open(fileName))
+        return false;
+
+    vector<long long> all;
+    long long ways = 0;
+    scanFile(reader, ways, [](string_view) {}, [&](const vector<long long> &refs, const WayTags &)
+    {
+        state.drivableWays++;
+        all.insert(all.end(), refs.begin(), refs.end());
+        all.push_back(refs.front()); // Endpoints count twice
+        all.push_back(refs.back());
+    });
+    state.ways = ways;
+
+    sort(all.begin(), all.end());
+    for (size_t i = 0; i < all.size();)
+    {
+        size_t j = i;
+        while (j < all.size() && all[j] == all[i])
+            j++;
+        state.referenced.push_back(all[i]);
+        state.references.push_back(static_cast<uint8_t>(min<size_t>(j - i, 255)));
+        i = j;
+    }
+
+    // Graph nodes get dense indices in ID order
+    state.graphIndex.assign(state.referenced.size(), -1);
+    for (size_t i = 0; i < state.referenced.size(); i++)
+    {
+        if (state.references[i] >= 2)
+            state.graphIndex[i] = state.graphNodes++;
+    }
+
+    state.latitudes.assign(state.referenced.size(), NO_COORDINATE);
+    state.longitudes.assign(state.referenced.size(), NO_COORDINATE);
+
+    cout << "Pass 1: " << reader.getBytesRead() / (1024 * 1024) << " MB, " << state.ways << " ways (" << state.drivableWays << " drivable), "
+         << state.referenced.size() << " road nodes, " << state.graphNodes << " of them junctions or ends" << endl;
+    return true;
+}
+
+// Emits the road along 'pointRefs': a graph node, its shape points, then the next graph node
+static void addRoad(Importer &state, const vector<int> &pointRefs, double metres, double speed, int direction)
+{
+    int from = state.graphIndex[pointRefs.front()];
+    int to = state.graphIndex[pointRefs.back()];
+    if (from == to)
+        return; // A loop back to its own start never shortens a route
+
+    if (direction == -1)
+        swap(from, to);
+
+    state.roads.push_back(ImportedRoad{from, to, metres / (speed / 3.6), direction != 0});
+    state.shapePoints += pointRefs.size() - 2;
+
+    if (state.geometry)
+    {
+        // "from to count x y ..." with the points in the road's direction
+        fprintf(state.geometry, "%d %d %zu", from, to, pointRefs.size());
+        for (size_t k = 0; k < pointRefs.size(); k++)
+        {
+            double x, y;
+            state.project(pointRefs[direction == -1 ? pointRefs.size() - 1 - k : k], x, y);
+            fprintf(state.geometry, " %.1f %.1f", x, y);
+        }
+        fprintf(state.geometry, "\n");
+    }
+}
+
+// Pass 2: coordinates of the referenced nodes, then the ways split into roads
+static bool buildRoads(const string &fileName, Importer &state)
+{
+    OsmReader reader;
+    if (!reader.open(fileName))
+        return false;
+
+    long long ways = 0;
+    vector<int> pointRefs;
+
+    auto onNode = [&](string_view tag)
+    {
+        long long id;
+        double lat, lon;
+        if (!attributeInt(tag, "id", id))
+            return;
+        int ref = state.find(id);
+        if (ref == -1 || !attributeDouble(tag, "lat", lat) || !attributeDouble(tag, "lon", lon))
+            return;
+        state.latitudes[ref] = static_cast<int32_t>(lround(lat * 1e7));
+        state.longitudes[ref] = static_cast<int32_t>(lround(lon * 1e7));
+    };
+
+    auto onWay = [&](const vector<long long> &refs, const WayTags &tags)
+    {
+        // OSM files list every node before the first way
+        if (!state.projected)
+            state.fixProjection();
+
+        double speed = speedOf(tags);
+        int direction = directionOf(tags);
+        double metres = 0.0;
+        pointRefs.clear();
+
+        for (long long id : refs)
+        {
+            int ref = state.find(id);
+            if (ref == -1 || state.latitudes[ref] == NO_COORDINATE)
+            {
+                // Node outside the extract: the way is cut here
+                state.missingPoints++;
+                pointRefs.clear();
+                metres = 0.0;
+                continue;
+            }
+
+            if (!pointRefs.empty())
+            {
+                int previous = pointRefs.back();
+                metres += geodesicLength(state.latitudes[previous], state.longitudes[previous], state.latitudes[ref], state.longitudes[ref]);
+            }
+            else if (state.graphIndex[ref] == -1)
+                continue; // Start again only at a graph node
+
+            pointRefs.push_back(ref);
+
+            if (pointRefs.size() >= 2 && state.graphIndex[ref] != -1)
+            {
+                addRoad(state, pointRefs, metres, speed, direction);
+                pointRefs.assign(1, ref);
+                metres = 0.0;
+            }
+        }
+    };
+
+    scanFile(reader, ways, onNode, onWay);
+
+    cout << "Pass 2: " << state.roads.size() << " roads, " << state.shapePoints << " shape points folded into them";
+    if (state.missingPoints > 0)
+        cout << ", " << state.missingPoints << " way nodes missing from the extract (ways cut there)";
+    cout << endl;
+    return true;
+}
+
+static bool writeTextMap(const string &fileName, const Importer &state)
+{
+    FILE *out = fopen(fileName.c_str(), "w");
+    if (!out)
+    {
+        cout << "Error in opening file " << fileName << endl;
+        return false;
+    }
+
+    fprintf(out, "%d\n", state.graphNodes);
+    for (size_t i = 0; i < state.referenced.size(); i++)
+    {
+        if (state.graphIndex[i] == -1 || state.latitudes[i] == NO_COORDINATE)
+            continue;
+        double x, y;
+        state.project(static_cast<int>(i), x, y);
+        fprintf(out, "node %d %.1f %.1f\n", state.graphIndex[i], x, y);
+    }
+
+    for (const ImportedRoad &road : state.roads)
+        fprintf(out, road.oneWay ? "arc %d %d %.3f\n" : "%d %d %.3f\n", road.from, road.to, road.seconds);
+
+    bool ok = (fclose(out) == 0);
+    if (ok)
+        cout << "Text map written to: " << fileName << endl;
+    else
+        cout << "Error writing text map to " << fileName << endl;
+    return ok;
+}
+
+static bool writeBinaryMap(const string &fileName, const Importer &state)
+{
+    Graph cityMap;
+    vector<sf::Vector2<float>> positions(state.graphNodes);
+    for (size_t i = 0; i < state.referenced.size(); i++)
+    {
+        if (state.graphIndex[i] == -1 || state.latitudes[i] == NO_COORDINATE)
+            continue;
+        double x, y;
+        state.project(static_cast<int>(i), x, y);
+        positions[state.graphIndex[i]] = sf::Vector2<float>(static_cast<float>(x), static_cast<float>(y));
+    }
+
+    for (int i = 0; i < state.graphNodes; i++)
+        cityMap.addNode(i, positions[i].x, positions[i].y);
+    for (const ImportedRoad &road : state.roads)
+        cityMap.addEdge(road.from, road.to, road.seconds, !road.oneWay);
+    cityMap.freeze();
+
+    return cityMap.saveBinary(fileName);
+}
+
+int main(int argc, char *argv[])
+{
+    string osmFile;
+    string textFile;
+    string binaryFile;
+    string geometryFile;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--osm" && hasValue)
+            osmFile = argv[++i];
+        else if (arg == "--output" && hasValue)
+            textFile = argv[++i];
+        else if (arg == "--binary" && hasValue)
+            binaryFile = argv[++i];
+        else if (arg == "--geometry" && hasValue)
+            geometryFile = argv[++i];
+        else
+        {
+            osmFile.clear();
+            break;
+        }
+    }
+
+    if (osmFile.empty() || (textFile.empty() && binaryFile.empty()))
+    {
+        cerr << "Usage: OsmImport --osm <file> [--output <text map>] [--binary <binary map>] [--geometry <file>]" << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    Importer state;
+    if (!countReferences(osmFile, state))
+        return 1;
+
+    if (!geometryFile.empty())
+    {
+        state.geometry = fopen(geometryFile.c_str(), "w");
+        if (!state.geometry)
+        {
+            cout << "Error in opening file " << geometryFile << endl;
+            return 1;
+        }
+    }
+
+    bool ok = buildRoads(osmFile, state);
+    if (state.geometry && fclose(state.geometry) != 0)
+    {
+        cout << "Error writing geometry to " << geometryFile << endl;
+        ok = false;
+    }
+
+    if (ok && !textFile.empty())
+        ok = writeTextMap(textFile, state);
+    if (ok && !binaryFile.empty())
+        ok = writeBinaryMap(binaryFile, state);
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Import took " << fixed << setprecision(2) << seconds << "s" << endl;
+    return ok ? 0 : 1;
+}